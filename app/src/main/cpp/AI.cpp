@@ -1,111 +1,573 @@
 #include "AI.h"
+#include "Bitboard.h"
+#include "MCTS.h"
+#include "NeuralEval.h"
+#include "ProbCut.h"
+#include "Snapshot.h"
+#include "SolvedStore.h"
+#include "Solver.h"
+#include "Trace.h"
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
 #include <climits>
+#include <cmath>
+#include <functional>
+#include <thread>
 
-AI::AI(GameEngine* gameEngine) : engine(gameEngine), difficulty(AIDifficulty::MEDIUM) {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+namespace {
+
+// Search window limits (kept well inside int range so null-window probes never overflow)
+constexpr int SCORE_INF = 1000000;
+
+// Score per disc of final margin; dominates any heuristic evaluation
+constexpr int WIN_SCORE = 1000;
+
+// Transposition table size (entries, power of two)
+constexpr size_t TT_SIZE = 1 << 16;
+
+// Heuristic points per disc of margin, for reporting only (the evaluation is not calibrated in discs)
+constexpr double HEURISTIC_PER_DISC = 10.0;
+
+// Check the clock once every this many nodes
+constexpr uint64_t DEADLINE_CHECK_INTERVAL = 2048;
+
+// Default Expert time budget per move
+constexpr int DEFAULT_TIME_BUDGET_MS = 1000;
+
+// Fixed search depth for Hard (below the root move)
+constexpr int HARD_SEARCH_DEPTH = 4;
+
+// Plies before the end of the game at which iterative deepening hands over to the exact
+// solver on bitboard sizes: it reaches the end sooner than the search reaches those plies
+constexpr int SOLVE_AHEAD_PLIES = 10;
+
+// Iteration that solves a position with `empties` empty squares. Positions with more empties
+// than the solved store keeps are out of the solver's reach, so they deepen plainly.
+template <int N>
+int solveDepthFor(int empties) {
+    if (N * N > 64 || empties > SOLVED_STORE_MAX_EMPTIES) return empties;
+    return std::max(1, empties - SOLVE_AHEAD_PLIES);
+}
+
+// Shallower transposition entries are cheaper to recompute than to persist
+constexpr int SNAPSHOT_MIN_TT_DEPTH = 2;
+
+// Serialized transposition entry: key, value, depth, bound, best move
+constexpr size_t SNAPSHOT_TT_ENTRY_SIZE = 8 + 4 + 1 + 1 + 1;
+
+// Evaluation that produced cached scores: the network's fingerprint, 0 for the built-in one
+uint64_t evaluationId(const NeuralEvaluator* network) {
+    return (network != nullptr) ? network->getFingerprint() : 0;
+}
+
+// Zobrist keys: one per square and colour, plus a side-to-move key
+template <int N>
+struct ZobristKeys {
+    uint64_t squares[N * N][3];
+    uint64_t whiteToMove;
+    
+    ZobristKeys() {
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        auto next = [&seed]() {
+            // splitmix64
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        for (int i = 0; i < N * N; i++) {
+            squares[i][EMPTY] = 0;
+            squares[i][BLACK] = next();
+            squares[i][WHITE] = next();
+        }
+        whiteToMove = next();
+    }
+};
+
+template <int N>
+const ZobristKeys<N> zobrist;
+
+// Positional weight of a square on an n x n board: corners are most valuable, squares
+// next to corners are bad, edges are good (reproduces the classic 8x8 table)
+constexpr int squareWeight(int row, int col, int n) {
+    int r = (row < n - 1 - row) ? row : n - 1 - row;
+    int c = (col < n - 1 - col) ? col : n - 1 - col;
+    int ring = (r < c) ? r : c;
+    int along = (r < c) ? c : r;
+    
+    if (ring == 0) {
+        if (along == 0) return 100;
+        if (along == 1) return -20;
+        if (along == 2) return 10;
+        return 5;
+    }
+    if (ring == 1) return (along == 1) ? -50 : -2;
+    if (ring == 2) return 1;
+    return 0;
+}
+
+template <int N>
+struct WeightTable {
+    int weights[N][N];
+    
+    constexpr WeightTable() : weights() {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                weights[i][j] = squareWeight(i, j, N);
+            }
+        }
+    }
+};
+
+template <int N>
+constexpr WeightTable<N> positionWeights;
+
+// Place Player's disc on (row, col) and flip the captured runs, calling onFlip(row, col)
+// for every flipped disc; returns the number of flipped discs
+template <int N, int Player, typename OnFlip>
+inline int placeDisc(int board[N][N], int row, int col, OnFlip&& onFlip) {
+    constexpr int opponent = opponentOf(Player);
+    int flipped = 0;
+    
+    for (int d = 0; d < 8; d++) {
+        int dr = DIRECTIONS[d][0];
+        int dc = DIRECTIONS[d][1];
+        int r = row + dr;
+        int c = col + dc;
+        int run = 0;
+        
+        while (r >= 0 && r < N && c >= 0 && c < N && board[r][c] == opponent) {
+            run++;
+            r += dr;
+            c += dc;
+        }
+        
+        // Flip the run only if it is closed by one of our own discs
+        if (run > 0 && r >= 0 && r < N && c >= 0 && c < N && board[r][c] == Player) {
+            for (int k = 1; k <= run; k++) {
+                board[row + k * dr][col + k * dc] = Player;
+                onFlip(row + k * dr, col + k * dc);
+            }
+            flipped += run;
+        }
+    }
+    
+    board[row][col] = Player;
+    return flipped;
 }
 
-AI::~AI() {
+} // namespace
+
+template <int N>
+BasicAI<N>::BasicAI(BasicGameEngine<N>* gameEngine)
+    : engine(gameEngine), difficulty(AIDifficulty::MEDIUM), aiPlayer(WHITE),
+      probCutEnabled(true), probCutConfidence(PROBCUT_DEFAULT_CONFIDENCE),
+      timeBudgetMs(DEFAULT_TIME_BUDGET_MS),
+      threadCount(std::max(1, static_cast<int>(std::thread::hardware_concurrency()))), useDeadline(false), searchAborted(false), stopSignal(nullptr),
+      nodeCount(0), lastSearchDepth(0), transpositionTable(TT_SIZE), selectiveSearch(false),
+      rng(static_cast<uint32_t>(std::time(nullptr))), neuralEvaluator(nullptr),
+      checkFeatures(false), featureMismatches(0), solverTableBits(SOLVER_MOBILE_TABLE_BITS), solvedStore(nullptr) {
+    clearCache();
 }
 
-void AI::setDifficulty(AIDifficulty diff) {
+template <int N>
+BasicAI<N>::~BasicAI() {
+}
+
+template <int N>
+void BasicAI<N>::setDifficulty(AIDifficulty diff) {
     difficulty = diff;
 }
 
-void AI::copyBoard(int src[8][8], int dest[8][8]) {
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
+template <int N>
+void BasicAI<N>::setProbCutEnabled(bool enabled) {
+    probCutEnabled = enabled;
+}
+
+template <int N>
+void BasicAI<N>::setProbCutConfidence(double confidence) {
+    if (confidence > 0.0) {
+        probCutConfidence = confidence;
+    }
+}
+
+template <int N>
+void BasicAI<N>::setSeed(uint32_t seed) {
+    rng.seed(seed);
+}
+
+template <int N>
+void BasicAI<N>::setNeuralEvaluator(const NeuralEvaluator* evaluator) {
+    if (evaluator != nullptr && !evaluator->isLoaded()) evaluator = nullptr;
+    if (N != NN_BOARD_SIZE) evaluator = nullptr;
+    if (evaluator == neuralEvaluator) return;
+    
+    // Cached scores came from the other evaluation
+    neuralEvaluator = evaluator;
+    clearCache();
+}
+
+template <int N>
+void BasicAI<N>::setSolvedStore(BasicSolvedStore<N>* store) {
+    if constexpr (N * N <= 64) {
+        solvedStore = store;
+        if (solver) solver->setStore(store);
+    } else {
+        (void)store;
+    }
+}
+
+template <int N>
+void BasicAI<N>::setSolverTableBits(int bits) {
+    // The next solve builds a table of the new size
+    if (bits != solverTableBits) solver.reset();
+    solverTableBits = bits;
+}
+
+template <int N>
+int BasicAI<N>::evaluateBoard(int board[N][N], int player) {
+    EvalFeatures features;
+    computeFeatures(board, features);
+    return (player == BLACK) ? evaluatePosition<BLACK>(board, features) : evaluatePosition<WHITE>(board, features);
+}
+
+template <int N>
+void BasicAI<N>::setTimeBudget(int milliseconds) {
+    if (milliseconds > 0) {
+        timeBudgetMs = milliseconds;
+    }
+}
+
+template <int N>
+void BasicAI<N>::setThreadCount(int threads) {
+    if (threads > 0) {
+        threadCount = threads;
+    }
+}
+
+template <int N>
+uint64_t BasicAI<N>::getNodeCount() const {
+    return nodeCount;
+}
+
+template <int N>
+int BasicAI<N>::getLastSearchDepth() const {
+    return lastSearchDepth;
+}
+
+template <int N>
+void BasicAI<N>::clearCache() {
+    std::fill(transpositionTable.begin(), transpositionTable.end(), TTEntry{0, 0, -1, TTBound::EXACT, -1});
+}
+
+template <int N>
+void BasicAI<N>::writeSnapshot(SnapshotWriter& writer, bool includeCaches) {
+    writer.writeU8(static_cast<uint8_t>(difficulty));
+    writer.writeU8(probCutEnabled ? 1 : 0);
+    writer.writeU32(static_cast<uint32_t>(probCutConfidence * 1000.0 + 0.5));
+    writer.writeU32(static_cast<uint32_t>(timeBudgetMs));
+    
+    writer.writeU8(includeCaches ? 1 : 0);
+    if (!includeCaches) return;
+    
+    // Only entries worth keeping are written; each is re-inserted at its hash index on load
+    uint32_t used = 0;
+    for (const auto& entry : transpositionTable) {
+        if (entry.depth >= SNAPSHOT_MIN_TT_DEPTH) used++;
+    }
+    writer.reserve(used * SNAPSHOT_TT_ENTRY_SIZE);
+    writer.writeU8(selectiveSearch ? 1 : 0);
+    writer.writeU64(evaluationId(neuralEvaluator));
+    writer.writeU32(used);
+    for (const auto& entry : transpositionTable) {
+        if (entry.depth < SNAPSHOT_MIN_TT_DEPTH) continue;
+        writer.writeU64(entry.key);
+        writer.writeI32(entry.value);
+        writer.writeI8(entry.depth);
+        writer.writeU8(static_cast<uint8_t>(entry.bound));
+        writer.writeI8(entry.bestMove);
+    }
+}
+
+template <int N>
+bool BasicAI<N>::readSnapshot(SnapshotReader& reader) {
+    uint8_t diff, probCut, hasCaches;
+    uint32_t confidence, budget;
+    if (!reader.readU8(&diff) || !reader.readU8(&probCut) || !reader.readU32(&confidence) ||
+        !reader.readU32(&budget) || !reader.readU8(&hasCaches)) {
+        return false;
+    }
+    if (diff > static_cast<uint8_t>(AIDifficulty::MCTS) || confidence == 0 || budget == 0) return false;
+    
+    std::vector<TTEntry> table;
+    uint8_t selective = 0;
+    uint64_t evaluation = 0;
+    if (hasCaches) {
+        uint32_t used;
+        if (!reader.readU8(&selective) || !reader.readU64(&evaluation) || !reader.readU32(&used) || used > TT_SIZE) {
+            return false;
+        }
+        
+        table.assign(TT_SIZE, TTEntry{0, 0, -1, TTBound::EXACT, -1});
+        for (uint32_t i = 0; i < used; i++) {
+            TTEntry entry;
+            uint8_t bound;
+            if (!reader.readU64(&entry.key) || !reader.readI32(&entry.value) || !reader.readI8(&entry.depth) ||
+                !reader.readU8(&bound) || !reader.readI8(&entry.bestMove)) {
+                return false;
+            }
+            if (bound > static_cast<uint8_t>(TTBound::UPPER) || entry.depth < 0 || entry.bestMove >= N * N) return false;
+            entry.bound = static_cast<TTBound>(bound);
+            table[entry.key & (TT_SIZE - 1)] = entry;
+        }
+    }
+    
+    // Last section of the snapshot: anything after it means the file is damaged
+    if (reader.remaining() != 0) return false;
+    
+    difficulty = static_cast<AIDifficulty>(diff);
+    probCutEnabled = probCut != 0;
+    probCutConfidence = confidence / 1000.0;
+    timeBudgetMs = static_cast<int>(budget);
+    
+    // Scores from another evaluation than the current one are dropped
+    if (hasCaches && evaluation == evaluationId(neuralEvaluator)) {
+        transpositionTable.swap(table);
+        selectiveSearch = selective != 0;
+    }
+    
+    return true;
+}
+
+template <int N>
+void BasicAI<N>::copyBoard(int src[N][N], int dest[N][N]) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
             dest[i][j] = src[i][j];
         }
     }
 }
 
-bool AI::isCorner(int row, int col) {
-    return (row == 0 || row == 7) && (col == 0 || col == 7);
+template <int N>
+template <int Player>
+bool BasicAI<N>::isValidMoveOn(int board[N][N], int row, int col) {
+    constexpr int opponent = opponentOf(Player);
+    if (board[row][col] != EMPTY) return false;
+    
+    for (int d = 0; d < 8; d++) {
+        int dr = DIRECTIONS[d][0];
+        int dc = DIRECTIONS[d][1];
+        int r = row + dr;
+        int c = col + dc;
+        bool sawOpponent = false;
+        
+        while (r >= 0 && r < N && c >= 0 && c < N && board[r][c] == opponent) {
+            sawOpponent = true;
+            r += dr;
+            c += dc;
+        }
+        
+        if (sawOpponent && r >= 0 && r < N && c >= 0 && c < N && board[r][c] == Player) {
+            return true;
+        }
+    }
+    return false;
 }
 
-bool AI::isXSquare(int row, int col) {
-    // Squares next to corners (that are not corners themselves)
-    // C-X1, C-X2, C-X3, C-X4 pattern
-    return (row == 0 && col == 1) || (row == 0 && col == 6) ||
-           (row == 1 && col == 0) || (row == 1 && col == 1) ||
-           (row == 1 && col == 6) || (row == 1 && col == 7) ||
-           (row == 6 && col == 0) || (row == 6 && col == 1) ||
-           (row == 6 && col == 6) || (row == 6 && col == 7) ||
-           (row == 7 && col == 1) || (row == 7 && col == 6);
-}
-
-bool AI::isEdge(int row, int col) {
-    return (row == 0 || row == 7 || col == 0 || col == 7) && !isCorner(row, col);
-}
-
-int AI::evaluatePosition(int board[8][8]) {
-    // Position weights for Reversi
-    // Corners are most valuable, X-squares are bad, edges are good
-    static const int weights[8][8] = {
-        {100, -20, 10,  5,  5, 10, -20, 100},
-        {-20, -50, -2, -2, -2, -2, -50, -20},
-        { 10,  -2,  1,  1,  1,  1,  -2,  10},
-        {  5,  -2,  1,  0,  0,  1,  -2,   5},
-        {  5,  -2,  1,  0,  0,  1,  -2,   5},
-        { 10,  -2,  1,  1,  1,  1,  -2,  10},
-        {-20, -50, -2, -2, -2, -2, -50, -20},
-        {100, -20, 10,  5,  5, 10, -20, 100}
-    };
-    
-    int score = 0;
-    int blackPieces = 0;
-    int whitePieces = 0;
-    
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (board[i][j] == WHITE) {
-                score += weights[i][j];
-                whitePieces++;
-            } else if (board[i][j] == BLACK) {
-                score -= weights[i][j];
-                blackPieces++;
-            }
+template <int N>
+template <int Player>
+int BasicAI<N>::applyMove(int board[N][N], int row, int col) {
+    return placeDisc<N, Player>(board, row, col, [](int, int) {});
+}
+
+template <int N>
+template <int Player>
+void BasicAI<N>::applyMove(int board[N][N], int row, int col, EvalFeatures& features) {
+    constexpr int opponent = opponentOf(Player);
+    
+    // Features are kept from White's point of view
+    constexpr int sign = (Player == WHITE) ? 1 : -1;
+    const auto& weights = positionWeights<N>.weights;
+    
+    [[maybe_unused]] uint64_t flippedDiscs = 0;
+    int flipped = placeDisc<N, Player>(board, row, col, [&](int r, int c) {
+        // The disc's weight changes sides
+        features.positional += 2 * sign * weights[r][c];
+        if constexpr (N * N <= 64) flippedDiscs |= Bitboard<N>::square(r, c);
+    });
+    
+    features.positional += sign * weights[row][col];
+    features.discCount[Player] += flipped + 1;
+    features.discCount[opponent] -= flipped;
+    features.discCount[EMPTY]--;
+    
+    if constexpr (N * N <= 64) {
+        features.discs[Player] |= flippedDiscs | Bitboard<N>::square(row, col);
+        features.discs[opponent] &= ~flippedDiscs;
+    }
+    if constexpr (N == NN_BOARD_SIZE) {
+        if (neuralEvaluator != nullptr) {
+            neuralEvaluator->applyMove(features.network, Player, row * N + col, flippedDiscs);
         }
     }
+}
+
+template <int N>
+void BasicAI<N>::computeFeatures(int board[N][N], EvalFeatures& features) {
+    const auto& weights = positionWeights<N>.weights;
+    features.positional = 0;
+    features.discCount[EMPTY] = 0;
+    features.discCount[BLACK] = 0;
+    features.discCount[WHITE] = 0;
+    features.discs[EMPTY] = 0;
+    features.discs[BLACK] = 0;
+    features.discs[WHITE] = 0;
     
-    // Late game: prioritize piece count over position
-    int totalPieces = blackPieces + whitePieces;
-    if (totalPieces > 50) {
-        // At end game, actual piece count matters more
-        // But position weights already account for this somewhat
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            int square = board[i][j];
+            features.discCount[square]++;
+            if (square == WHITE) features.positional += weights[i][j];
+            else if (square == BLACK) features.positional -= weights[i][j];
+            
+            if constexpr (N * N <= 64) {
+                if (square != EMPTY) features.discs[square] |= Bitboard<N>::square(i, j);
+            }
+        }
     }
     
-    // Add mobility bonus
-    int whiteMobility = 0;
-    int blackMobility = 0;
+    if constexpr (N == NN_BOARD_SIZE) {
+        if (neuralEvaluator != nullptr) {
+            neuralEvaluator->refresh(features.network, features.discs[BLACK], features.discs[WHITE]);
+        }
+    }
+}
+
+template <int N>
+void BasicAI<N>::verifyFeatures(int board[N][N], const EvalFeatures& features) {
+    EvalFeatures expected;
+    computeFeatures(board, expected);
     
-    // Simple mobility check
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (board[i][j] == EMPTY) {
-                // Check if white can move here
-                if (engine->canMove(i, j, WHITE)) whiteMobility++;
-                // Check if black can move here  
-                if (engine->canMove(i, j, BLACK)) blackMobility++;
+    bool match = features.positional == expected.positional &&
+                 std::equal(features.discCount, features.discCount + 3, expected.discCount) &&
+                 std::equal(features.discs, features.discs + 3, expected.discs);
+    if (N == NN_BOARD_SIZE && neuralEvaluator != nullptr) {
+        match = match && std::equal(features.network.values, features.network.values + NN_HIDDEN1,
+                                    expected.network.values);
+    }
+    if (!match) featureMismatches++;
+}
+
+template <int N>
+void BasicAI<N>::setFeatureCheck(bool enabled) {
+    checkFeatures = enabled;
+    featureMismatches = 0;
+}
+
+template <int N>
+uint64_t BasicAI<N>::getFeatureMismatchCount() const {
+    return featureMismatches;
+}
+
+template <int N>
+int BasicAI<N>::applyMove(int board[N][N], int row, int col, int player) {
+    return (player == BLACK) ? applyMove<BLACK>(board, row, col) : applyMove<WHITE>(board, row, col);
+}
+
+template <int N>
+template <int Player>
+std::vector<std::pair<int, int>> BasicAI<N>::generateMoves(int board[N][N]) {
+    std::vector<std::pair<int, int>> moves;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            if (isValidMoveOn<Player>(board, i, j)) {
+                moves.push_back({i, j});
             }
         }
     }
+    return moves;
+}
+
+template <int N>
+std::vector<std::pair<int, int>> BasicAI<N>::generateMoves(int board[N][N], int player) {
+    return (player == BLACK) ? generateMoves<BLACK>(board) : generateMoves<WHITE>(board);
+}
+
+template <int N>
+int BasicAI<N>::countDiscs(int board[N][N]) {
+    int discs = 0;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            if (board[i][j] != EMPTY) discs++;
+        }
+    }
+    return discs;
+}
+
+template <int N>
+bool BasicAI<N>::isCorner(int row, int col) {
+    return (row == 0 || row == N - 1) && (col == 0 || col == N - 1);
+}
+
+template <int N>
+bool BasicAI<N>::isXSquare(int row, int col) {
+    // Squares next to corners (that are not corners themselves)
+    // C-X1, C-X2, C-X3, C-X4 pattern
+    int r = std::min(row, N - 1 - row);
+    int c = std::min(col, N - 1 - col);
+    return r <= 1 && c <= 1 && !(r == 0 && c == 0);
+}
+
+template <int N>
+bool BasicAI<N>::isEdge(int row, int col) {
+    return (row == 0 || row == N - 1 || col == 0 || col == N - 1) && !isCorner(row, col);
+}
+
+template <int N>
+template <int Player>
+int BasicAI<N>::evaluatePosition(int board[N][N], const EvalFeatures& features) {
+    if constexpr (N == NN_BOARD_SIZE) {
+        if (neuralEvaluator != nullptr) {
+            // Heuristic scores must stay below any proven result
+            int score = std::max(-(WIN_SCORE - 1), std::min(WIN_SCORE - 1, neuralEvaluator->evaluate(features.network)));
+            return (Player == WHITE) ? score : -score;
+        }
+    }
+    
+    // Position weights (corners are most valuable, X-squares are bad, edges are good)
+    // and mobility, from White's point of view
+    int score = features.positional;
     
-    // Add mobility evaluation
-    if (whiteMobility > 0) score += whiteMobility;
-    if (blackMobility > 0) score -= blackMobility;
+    if constexpr (N * N <= 64) {
+        using Board = Bitboard<N>;
+        score += Board::popCount(Board::legalMoves(features.discs[WHITE], features.discs[BLACK])) -
+                 Board::popCount(Board::legalMoves(features.discs[BLACK], features.discs[WHITE]));
+    } else {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                if (board[i][j] != EMPTY) continue;
+                int movers = moversAt<N>(board, i, j);
+                score += ((movers >> WHITE) & 1) - ((movers >> BLACK) & 1);
+            }
+        }
+    }
     
-    return score;
+    // Resolved at compile time for each side to move
+    return (Player == WHITE) ? score : -score;
 }
 
-int AI::countMobility(int player) {
+template <int N>
+template <int Player>
+int BasicAI<N>::finalScore(const EvalFeatures& features) {
+    return (features.discCount[Player] - features.discCount[opponentOf(Player)]) * WIN_SCORE;
+}
+
+template <int N>
+int BasicAI<N>::countMobility(int player) {
     int count = 0;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
             if (engine->canMove(i, j, player)) {
                 count++;
             }
@@ -114,17 +576,223 @@ int AI::countMobility(int player) {
     return count;
 }
 
-std::pair<int, int> AI::getEasyMove() {
-    auto validMoves = engine->getValidMoves(WHITE);
+template <int N>
+template <int Player>
+uint64_t BasicAI<N>::hashBoard(int board[N][N]) {
+    uint64_t key = 0;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            key ^= zobrist<N>.squares[i * N + j][board[i][j]];
+        }
+    }
+    // Scores are stored from the side to move's point of view
+    if (Player == WHITE) key ^= zobrist<N>.whiteToMove;
+    return key;
+}
+
+template <int N>
+TTEntry* BasicAI<N>::probeTT(uint64_t key) {
+    TTEntry& entry = transpositionTable[key & (TT_SIZE - 1)];
+    return (entry.key == key && entry.depth >= 0) ? &entry : nullptr;
+}
+
+template <int N>
+void BasicAI<N>::storeTT(uint64_t key, int value, int depth, TTBound bound, int bestMove) {
+    TTEntry& entry = transpositionTable[key & (TT_SIZE - 1)];
+    // Keep deeper results for the same position; otherwise always replace
+    if (entry.key == key && entry.depth > depth) return;
+    entry.key = key;
+    entry.value = value;
+    entry.depth = static_cast<int8_t>(depth);
+    entry.bound = bound;
+    entry.bestMove = static_cast<int8_t>(bestMove);
+}
+
+template <int N>
+bool BasicAI<N>::checkDeadline() {
+    if (!useDeadline) return false;
+    if (!searchAborted && (nodeCount % DEADLINE_CHECK_INTERVAL) == 0 &&
+        (std::chrono::steady_clock::now() >= searchDeadline ||
+         (stopSignal != nullptr && stopSignal->load(std::memory_order_relaxed)))) {
+        searchAborted = true;
+    }
+    return searchAborted;
+}
+
+template <int N>
+void BasicAI<N>::beginSearch(bool selective) {
+    // The cut parameters are fitted for one board size and the table evaluation only
+    selective = selective && N == PROBCUT_BOARD_SIZE && neuralEvaluator == nullptr;
+    
+    // Cached bounds from a selective search are not valid for a full-width one (and vice versa)
+    if (selective != selectiveSearch) {
+        clearCache();
+        selectiveSearch = selective;
+    }
+    nodeCount = 0;
+    searchAborted = false;
+    useDeadline = false;
+    stopSignal = nullptr;
+}
+
+template <int N>
+bool BasicAI<N>::searchRoot(int board[N][N], std::vector<std::pair<int, int>>& moves,
+                            std::vector<AnalyzedMove>& ranked, int depth, int moveCount) {
+    TRACE_SCOPE_ARG("search.iteration", "depth", depth);
+    // Exact scores of the best moves so far (descending); a move that cannot beat the
+    // last of them is only searched with a null window above it and fails low
+    std::vector<int> best;
+    ranked.clear();
+    
+    for (const auto& move : moves) {
+        int tempBoard[N][N];
+        copyBoard(board, tempBoard);
+        applyMove(tempBoard, move.first, move.second, aiPlayer);
+        
+        int threshold = (static_cast<int>(best.size()) < moveCount) ? -SCORE_INF : best.back();
+        int score = -search(tempBoard, opponentOf(aiPlayer), depth - 1, -SCORE_INF, -threshold);
+        if (searchAborted) return false;
+        
+        bool exact = score > threshold;
+        if (exact) {
+            best.insert(std::upper_bound(best.begin(), best.end(), score, std::greater<int>()), score);
+            if (static_cast<int>(best.size()) > moveCount) best.pop_back();
+        }
+        ranked.push_back({move.first, move.second, score, exact});
+    }
+    
+    rankRoot(moves, ranked, moveCount);
+    return true;
+}
+
+template <int N>
+bool BasicAI<N>::solveRoot(int board[N][N], std::vector<std::pair<int, int>>& moves,
+                           std::vector<AnalyzedMove>& ranked, int moveCount) {
+    if constexpr (N * N > 64) {
+        return searchRoot(board, moves, ranked, N * N - countDiscs(board), moveCount);
+    } else {
+        TRACE_SCOPE_ARG("search.solve", "moves", moveCount);
+        if (!solver) {
+            solver = std::make_unique<BasicSolver<N>>(solverTableBits);
+            solver->setStore(solvedStore);
+        }
+        solver->setDeadline(searchDeadline, stopSignal);
+        uint64_t solverNodes = solver->getNodeCount();
+        
+        uint64_t own;
+        uint64_t other;
+        Bitboard<N>::fromBoard(&board[0][0], aiPlayer, &own, &other);
+        
+        // Same scheme as searchRoot, in disc margins: the best moves exactly, the others only
+        // proven not to beat the last of them
+        std::vector<int> best;
+        ranked.clear();
+        for (const auto& move : moves) {
+            int square = move.first * N + move.second;
+            uint64_t flipped = Bitboard<N>::flips(own, other, square);
+            uint64_t nextPlayer = other & ~flipped;
+            uint64_t nextOpponent = own | flipped | (1ULL << square);
+            
+            bool exact = static_cast<int>(best.size()) < moveCount;
+            int margin;
+            if (exact) {
+                margin = -solver->solve(nextPlayer, nextOpponent);
+            } else {
+                int threshold = best.back();
+                margin = -solver->solveWindow(nextPlayer, nextOpponent, -threshold - 1, -threshold);
+                if (!solver->wasAborted() && margin > threshold) {
+                    margin = -solver->solve(nextPlayer, nextOpponent);
+                    exact = true;
+                }
+            }
+            if (solver->wasAborted()) {
+                searchAborted = true;
+                break;
+            }
+            
+            if (exact) {
+                best.insert(std::upper_bound(best.begin(), best.end(), margin, std::greater<int>()), margin);
+                if (static_cast<int>(best.size()) > moveCount) best.pop_back();
+            }
+            ranked.push_back({move.first, move.second, margin * WIN_SCORE, exact});
+        }
+        
+        solver->clearDeadline();
+        nodeCount += solver->getNodeCount() - solverNodes;
+        if (searchAborted) return false;
+        
+        rankRoot(moves, ranked, moveCount);
+        if (solvedStore != nullptr) {
+            solvedStore->add(own, other, ranked[0].score / WIN_SCORE, ranked[0].row * N + ranked[0].col);
+        }
+        return true;
+    }
+}
+
+template <int N>
+bool BasicAI<N>::storedRoot(int board[N][N], std::vector<std::pair<int, int>>& moves,
+                            std::vector<AnalyzedMove>& ranked) {
+    if constexpr (N * N > 64) {
+        return false;
+    } else {
+        int empties = N * N - countDiscs(board);
+        if (solvedStore == nullptr || empties < SOLVED_STORE_MIN_EMPTIES || empties > SOLVED_STORE_MAX_EMPTIES) {
+            return false;
+        }
+        
+        uint64_t own;
+        uint64_t other;
+        Bitboard<N>::fromBoard(&board[0][0], aiPlayer, &own, &other);
+        int score;
+        int bestMove;
+        if (!solvedStore->lookup(own, other, &score, &bestMove) || bestMove < 0) return false;
+        
+        ranked.clear();
+        for (const auto& move : moves) {
+            bool stored = move.first * N + move.second == bestMove;
+            ranked.push_back({move.first, move.second, score * WIN_SCORE, stored});
+        }
+        rankRoot(moves, ranked, 1);
+        return ranked[0].exact;
+    }
+}
+
+template <int N>
+void BasicAI<N>::rankRoot(std::vector<std::pair<int, int>>& moves, std::vector<AnalyzedMove>& ranked,
+                          int moveCount) {
+    // Exact scores rank above bounds of the same value; ties keep the search order
+    std::stable_sort(ranked.begin(), ranked.end(), [](const AnalyzedMove& a, const AnalyzedMove& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.exact && !b.exact;
+    });
+    
+    // Search the ranked moves first in the next iteration, the rest in their previous order
+    int top = std::min(moveCount, static_cast<int>(ranked.size()));
+    std::vector<std::pair<int, int>> reordered;
+    for (int i = 0; i < top; i++) {
+        reordered.push_back({ranked[i].row, ranked[i].col});
+    }
+    for (const auto& move : moves) {
+        if (std::find(reordered.begin(), reordered.begin() + top, move) == reordered.begin() + top) {
+            reordered.push_back(move);
+        }
+    }
+    moves.swap(reordered);
+}
+
+template <int N>
+std::pair<int, int> BasicAI<N>::getEasyMove() {
+    auto validMoves = engine->getValidMoves(engine->getCurrentPlayer());
     if (validMoves.empty()) return {-1, -1};
     
     // Return a random valid move
-    int randomIndex = std::rand() % validMoves.size();
+    int randomIndex = rng() % validMoves.size();
     return validMoves[randomIndex];
 }
 
-std::pair<int, int> AI::getMediumMove() {
-    auto validMoves = engine->getValidMoves(WHITE);
+template <int N>
+std::pair<int, int> BasicAI<N>::getMediumMove() {
+    auto validMoves = engine->getValidMoves(engine->getCurrentPlayer());
     if (validMoves.empty()) return {-1, -1};
     
     // Find the move that flips the most pieces
@@ -134,7 +802,7 @@ std::pair<int, int> AI::getMediumMove() {
     for (const auto& move : validMoves) {
         // Count flippable pieces without actually making the move
         // We need to simulate this
-        int tempBoard[8][8];
+        int tempBoard[N][N];
         engine->getBoardState(&tempBoard[0][0]);
         
         // This is a simplification - in a real implementation, we'd have a method
@@ -146,16 +814,16 @@ std::pair<int, int> AI::getMediumMove() {
     }
     
     // If no corners, pick randomly from remaining moves
-    int randomIndex = std::rand() % validMoves.size();
+    int randomIndex = rng() % validMoves.size();
     return validMoves[randomIndex];
 }
 
-std::pair<int, int> AI::getHardMove() {
-    return getExpertMove(); // For simplicity, use the expert algorithm with reduced depth
-}
-
-std::pair<int, int> AI::getExpertMove() {
-    auto validMoves = engine->getValidMoves(WHITE);
+template <int N>
+std::pair<int, int> BasicAI<N>::getHardMove() {
+    aiPlayer = engine->getCurrentPlayer();
+    beginSearch(false);
+    
+    auto validMoves = engine->getValidMoves(aiPlayer);
     if (validMoves.empty()) return {-1, -1};
     
     // First priority: take any available corners
@@ -171,7 +839,7 @@ std::pair<int, int> AI::getExpertMove() {
     int bestCol = validMoves[0].second;
     int bestScore = INT_MIN;
     
-    int board[8][8];
+    int board[N][N];
     engine->getBoardState(&board[0][0]);
     
     for (const auto& move : validMoves) {
@@ -180,14 +848,11 @@ std::pair<int, int> AI::getExpertMove() {
         }
         
         // Simulate move
-        int tempBoard[8][8];
+        int tempBoard[N][N];
         copyBoard(board, tempBoard);
-        tempBoard[move.first][move.second] = WHITE;
-        
-        // Count flips and flip them (simplified)
-        // In a full implementation, we'd properly simulate the move
+        applyMove(tempBoard, move.first, move.second, aiPlayer);
         
-        int score = minimax(tempBoard, 4, INT_MIN, INT_MAX, false);
+        int score = -search(tempBoard, opponentOf(aiPlayer), HARD_SEARCH_DEPTH, -SCORE_INF, SCORE_INF);
         
         if (score > bestScore) {
             bestScore = score;
@@ -198,83 +863,293 @@ std::pair<int, int> AI::getExpertMove() {
     
     // If we skipped all X-squares but no good moves found, take any valid move
     if (bestScore == INT_MIN) {
-        int randomIndex = std::rand() % validMoves.size();
+        int randomIndex = rng() % validMoves.size();
         return validMoves[randomIndex];
     }
     
     return {bestRow, bestCol};
 }
 
-int AI::minimax(int board[8][8], int depth, int alpha, int beta, bool maximizingPlayer) {
-    if (depth == 0) {
-        return evaluatePosition(board);
+template <int N>
+std::pair<int, int> BasicAI<N>::getExpertMove() {
+    aiPlayer = engine->getCurrentPlayer();
+    beginSearch(probCutEnabled);
+    lastSearchDepth = 0;
+    
+    int board[N][N];
+    engine->getBoardState(&board[0][0]);
+    
+    auto validMoves = generateMoves(board, aiPlayer);
+    if (validMoves.empty()) return {-1, -1};
+    if (validMoves.size() == 1) return validMoves[0];
+    
+    searchDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeBudgetMs);
+    useDeadline = true;
+    
+    // Iterative deepening: each completed iteration orders the next one, and an
+    // iteration interrupted by the deadline is discarded
+    std::pair<int, int> bestMove = validMoves[0];
+    int empties = N * N - countDiscs(board);
+    std::vector<AnalyzedMove> ranked;
+    
+    // A position solved before is played without searching
+    if (storedRoot(board, validMoves, ranked)) {
+        useDeadline = false;
+        lastSearchDepth = empties;
+        return validMoves[0];
     }
     
-    int player = maximizingPlayer ? WHITE : BLACK;
-    auto validMoves = engine->getValidMoves(player);
+    int solveDepth = solveDepthFor<N>(empties);
+    for (int depth = 1; depth <= solveDepth; depth++) {
+        bool completed = (depth == solveDepth) ? solveRoot(board, validMoves, ranked, 1)
+                                               : searchRoot(board, validMoves, ranked, depth, 1);
+        if (!completed) break;
+        bestMove = validMoves[0];
+        lastSearchDepth = (depth == solveDepth) ? empties : depth;
+    }
     
-    if (validMoves.empty()) {
-        // Check if game is over
-        bool gameOver = true;
-        for (int i = 0; i < 8 && gameOver; i++) {
-            for (int j = 0; j < 8; j++) {
-                if (board[i][j] == EMPTY) {
-                    gameOver = false;
-                    break;
-                }
+    useDeadline = false;
+    return bestMove;
+}
+
+template <int N>
+std::pair<int, int> BasicAI<N>::getMctsMove() {
+    if constexpr (N * N > 64) {
+        // The playouts run on 64-bit bitboards
+        return getExpertMove();
+    } else {
+        aiPlayer = engine->getCurrentPlayer();
+        nodeCount = 0;
+        lastSearchDepth = 0;
+        
+        auto validMoves = engine->getValidMoves(aiPlayer);
+        if (validMoves.empty()) return {-1, -1};
+        if (validMoves.size() == 1) return validMoves[0];
+        
+        int board[N][N];
+        engine->getBoardState(&board[0][0]);
+        
+        if (!mcts) {
+            mcts = std::make_unique<BasicMCTS<N>>();
+        }
+        mcts->setSeed((static_cast<uint64_t>(rng()) << 32) | rng());
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeBudgetMs);
+        int square = mcts->search(&board[0][0], aiPlayer, deadline, threadCount, nullptr);
+        nodeCount = mcts->getPlayoutCount();
+        
+        if (square < 0) return validMoves[0];
+        return {square / N, square % N};
+    }
+}
+
+template <int N>
+AnalysisResult BasicAI<N>::analyze(int maxDepth, int timeMs, int moveCount, const std::atomic<bool>* stop,
+                                   const std::function<void(const AnalysisResult&)>& onIteration) {
+    TRACE_SCOPE_ARG("AI::analyze", "moves", moveCount);
+    aiPlayer = engine->getCurrentPlayer();
+    beginSearch(probCutEnabled);
+    lastSearchDepth = 0;
+    
+    AnalysisResult result{{}, 0, 0};
+    int board[N][N];
+    engine->getBoardState(&board[0][0]);
+    
+    auto validMoves = generateMoves(board, aiPlayer);
+    if (validMoves.empty()) return result;
+    
+    stopSignal = stop;
+    searchDeadline = (timeMs > 0) ? std::chrono::steady_clock::now() + std::chrono::milliseconds(timeMs)
+                                  : std::chrono::steady_clock::time_point::max();
+    useDeadline = true;
+    
+    int empties = N * N - countDiscs(board);
+    int lastDepth = std::min(maxDepth, empties);
+    std::vector<AnalyzedMove> ranked;
+    
+    // A single best move solved before needs no search (reported at full depth)
+    int firstDepth = 1;
+    if (moveCount <= 1 && storedRoot(board, validMoves, ranked)) {
+        result.moves = ranked;
+        result.depth = empties;
+        lastSearchDepth = empties;
+        if (onIteration) onIteration(result);
+        firstDepth = lastDepth + 1;
+    }
+    
+    // Reaching the depth of the solve means solving
+    int solveDepth = solveDepthFor<N>(empties);
+    if (lastDepth >= solveDepth) lastDepth = solveDepth;
+    for (int depth = firstDepth; depth <= lastDepth; depth++) {
+        bool completed = (depth == solveDepth) ? solveRoot(board, validMoves, ranked, std::max(moveCount, 1))
+                                               : searchRoot(board, validMoves, ranked, depth, std::max(moveCount, 1));
+        if (!completed) break;
+        result.moves = ranked;
+        result.depth = (depth == solveDepth) ? empties : depth;
+        result.nodes = nodeCount;
+        lastSearchDepth = result.depth;
+        if (onIteration) onIteration(result);
+    }
+    
+    useDeadline = false;
+    stopSignal = nullptr;
+    
+    // Stopped before the first iteration completed: unranked moves
+    if (result.moves.empty()) {
+        for (const auto& move : validMoves) {
+            result.moves.push_back({move.first, move.second, 0, false});
+        }
+    }
+    result.nodes = nodeCount;
+    return result;
+}
+
+template <int N>
+double BasicAI<N>::scoreInDiscs(int score) {
+    if (std::abs(score) >= WIN_SCORE) return static_cast<double>(score) / WIN_SCORE;
+    
+    double discs = score / HEURISTIC_PER_DISC;
+    return std::max(-(N * N - 1.0), std::min(N * N - 1.0, discs));
+}
+
+template <int N>
+int BasicAI<N>::searchPosition(int board[N][N], int player, int depth, bool selective) {
+    TRACE_SCOPE_ARG("AI::searchPosition", "depth", depth);
+    aiPlayer = player;
+    beginSearch(selective);
+    return search(board, player, depth, -SCORE_INF, SCORE_INF);
+}
+
+template <int N>
+int BasicAI<N>::search(int board[N][N], int player, int depth, int alpha, int beta) {
+    EvalFeatures features;
+    computeFeatures(board, features);
+    return (player == BLACK) ? negamax<BLACK>(board, features, depth, alpha, beta)
+                             : negamax<WHITE>(board, features, depth, alpha, beta);
+}
+
+template <int N>
+template <int Player>
+bool BasicAI<N>::tryProbCut(int board[N][N], const EvalFeatures& features, int depth, int alpha, int beta,
+                            int* cutValue) {
+    if (depth < PROBCUT_MIN_DEPTH || depth > PROBCUT_MAX_DEPTH) return false;
+    
+    int stage = getProbCutStage(features.discCount[BLACK] + features.discCount[WHITE]);
+    
+    for (int attempt = 0; attempt < PROBCUT_TRIES; attempt++) {
+        const ProbCutParams* params = getProbCutParams(stage, depth, attempt);
+        if (params == nullptr) continue;
+        
+        double margin = probCutConfidence * params->sigma;
+        
+        // The regression only models heuristic scores, not final disc margins
+        if (std::abs(beta) < WIN_SCORE) {
+            // Shallow value v' predicts the deep value as a * v' + b; the deep value
+            // is likely >= beta if a * v' + b - margin >= beta
+            int bound = static_cast<int>(std::lround((beta + margin - params->b) / params->a));
+            if (negamax<Player>(board, features, params->shallowDepth, bound - 1, bound) >= bound) {
+                *cutValue = beta;
+                return true;
             }
         }
         
-        if (gameOver) {
-            // Count final score
-            int whiteScore = 0, blackScore = 0;
-            for (int i = 0; i < 8; i++) {
-                for (int j = 0; j < 8; j++) {
-                    if (board[i][j] == WHITE) whiteScore++;
-                    else if (board[i][j] == BLACK) blackScore++;
-                }
+        if (std::abs(alpha) < WIN_SCORE) {
+            int bound = static_cast<int>(std::lround((alpha - margin - params->b) / params->a));
+            if (negamax<Player>(board, features, params->shallowDepth, bound, bound + 1) <= bound) {
+                *cutValue = alpha;
+                return true;
             }
-            return (whiteScore - blackScore) * 1000;
+        }
+        
+        if (searchAborted) return false;
+    }
+    
+    return false;
+}
+
+template <int N>
+template <int Player>
+int BasicAI<N>::negamax(int board[N][N], const EvalFeatures& features, int depth, int alpha, int beta) {
+    constexpr int opponent = opponentOf(Player);
+    
+    nodeCount++;
+    if (checkDeadline()) return 0;
+    if (checkFeatures) verifyFeatures(board, features);
+    
+    if (depth == 0) {
+        return evaluatePosition<Player>(board, features);
+    }
+    
+    auto validMoves = generateMoves<Player>(board);
+    
+    if (validMoves.empty()) {
+        // Game over if neither side can move
+        if (generateMoves<opponent>(board).empty()) {
+            return finalScore<Player>(features);
         }
         
         // Player must pass
-        return minimax(board, depth - 1, alpha, beta, !maximizingPlayer);
+        return -negamax<opponent>(board, features, depth - 1, -beta, -alpha);
     }
     
-    if (maximizingPlayer) {
-        int maxEval = INT_MIN;
-        for (const auto& move : validMoves) {
-            int tempBoard[8][8];
-            copyBoard(board, tempBoard);
-            tempBoard[move.first][move.second] = WHITE;
-            
-            // Flip pieces would happen here in full implementation
-            
-            int eval = minimax(tempBoard, depth - 1, alpha, beta, false);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-            if (beta <= alpha) break;
+    // Transposition table cutoff and move ordering
+    uint64_t key = hashBoard<Player>(board);
+    int ttMove = -1;
+    if (TTEntry* entry = probeTT(key)) {
+        ttMove = entry->bestMove;
+        if (entry->depth >= depth) {
+            if (entry->bound == TTBound::EXACT) return entry->value;
+            if (entry->bound == TTBound::LOWER && entry->value >= beta) return entry->value;
+            if (entry->bound == TTBound::UPPER && entry->value <= alpha) return entry->value;
         }
-        return maxEval;
-    } else {
-        int minEval = INT_MAX;
-        for (const auto& move : validMoves) {
-            int tempBoard[8][8];
-            copyBoard(board, tempBoard);
-            tempBoard[move.first][move.second] = BLACK;
-            
-            // Flip pieces would happen here in full implementation
-            
-            int eval = minimax(tempBoard, depth - 1, alpha, beta, true);
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, eval);
-            if (beta <= alpha) break;
+    }
+    
+    // Multi-ProbCut: let shallow searches predict the result of this one
+    if (selectiveSearch) {
+        int cutValue;
+        if (tryProbCut<Player>(board, features, depth, alpha, beta, &cutValue)) {
+            return cutValue;
+        }
+        if (searchAborted) return 0;
+    }
+    
+    if (ttMove >= 0) {
+        auto it = std::find(validMoves.begin(), validMoves.end(), std::make_pair(ttMove / N, ttMove % N));
+        if (it != validMoves.end()) std::iter_swap(validMoves.begin(), it);
+    }
+    
+    int alphaOrig = alpha;
+    int bestEval = -SCORE_INF;
+    int bestMove = -1;
+    
+    for (const auto& move : validMoves) {
+        int tempBoard[N][N];
+        EvalFeatures childFeatures = features;
+        copyBoard(board, tempBoard);
+        applyMove<Player>(tempBoard, move.first, move.second, childFeatures);
+        
+        int eval = -negamax<opponent>(tempBoard, childFeatures, depth - 1, -beta, -alpha);
+        if (eval > bestEval) {
+            bestEval = eval;
+            bestMove = move.first * N + move.second;
         }
-        return minEval;
+        alpha = std::max(alpha, eval);
+        if (beta <= alpha) break;
     }
+    
+    // Never cache results of an interrupted search
+    if (searchAborted) return 0;
+    
+    TTBound bound = TTBound::EXACT;
+    if (bestEval <= alphaOrig) bound = TTBound::UPPER;
+    else if (bestEval >= beta) bound = TTBound::LOWER;
+    storeTT(key, bestEval, depth, bound, bestMove);
+    
+    return bestEval;
 }
 
-std::pair<int, int> AI::getBestMove() {
+template <int N>
+std::pair<int, int> BasicAI<N>::getBestMove() {
+    TRACE_SCOPE_ARG("AI::getBestMove", "difficulty", static_cast<int>(difficulty));
     switch (difficulty) {
         case AIDifficulty::EASY:
             return getEasyMove();
@@ -284,17 +1159,26 @@ std::pair<int, int> AI::getBestMove() {
             return getHardMove();
         case AIDifficulty::EXPERT:
             return getExpertMove();
+        case AIDifficulty::MCTS:
+            return getMctsMove();
         default:
             return getMediumMove();
     }
 }
 
-const char* AI::getDifficultyName(AIDifficulty diff) {
+template <int N>
+const char* BasicAI<N>::getDifficultyName(AIDifficulty diff) {
     switch (diff) {
         case AIDifficulty::EASY: return "Easy";
         case AIDifficulty::MEDIUM: return "Medium";
         case AIDifficulty::HARD: return "Hard";
         case AIDifficulty::EXPERT: return "Expert";
+        case AIDifficulty::MCTS: return "Monte Carlo";
         default: return "Unknown";
     }
 }
+
+// Supported board sizes
+template class BasicAI<6>;
+template class BasicAI<8>;
+template class BasicAI<10>;
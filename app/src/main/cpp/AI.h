@@ -2,24 +2,145 @@
 #define REVERSI_AI_H
 
 #include "GameEngine.h"
+#include "NeuralEval.h"
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+template <int N>
+class BasicSolver;
+template <int N>
+class BasicSolvedStore;
+template <int N>
+class BasicMCTS;
 
 // AI Difficulty Levels
 enum class AIDifficulty {
     EASY = 0,
     MEDIUM = 1,
     HARD = 2,
-    EXPERT = 3
+    EXPERT = 3,
+    MCTS = 4        // Monte-Carlo Tree Search under the time budget
+};
+
+// Transposition table entry bound types
+enum class TTBound : uint8_t {
+    EXACT = 0,
+    LOWER = 1,
+    UPPER = 2
+};
+
+// Transposition table entry (keyed by Zobrist hash of board + side to move)
+struct TTEntry {
+    uint64_t key;
+    int32_t value;
+    int8_t depth;
+    TTBound bound;
+    int8_t bestMove;    // row * N + col, -1 if none
+};
+
+// One root move of an analysis search
+struct AnalyzedMove {
+    int row;
+    int col;
+    int score;      // side to move's point of view; an upper bound unless `exact`
+    bool exact;
 };
 
-class AI {
+// Analysis of a position: moves ranked best first, the requested number with exact scores
+struct AnalysisResult {
+    std::vector<AnalyzedMove> moves;
+    int depth;      // deepest completed iteration (0 if none)
+    uint64_t nodes;
+};
+
+// Computer player for an N x N game; the supported sizes are instantiated in AI.cpp
+template <int N>
+class BasicAI {
 private:
-    GameEngine* engine;
+    // Evaluation features of a search position, updated from each move's flips instead of
+    // rescanning the board at every leaf
+    struct EvalFeatures {
+        int positional;         // White's square weights minus Black's
+        int discCount[3];       // discs per colour (EMPTY: empty squares)
+        uint64_t discs[3];      // disc bitboards per colour, EMPTY unused (boards of up to 64 squares)
+        NNAccumulator network;  // first network layer (only while a network is set)
+    };
+    
+    BasicGameEngine<N>* engine;
     AIDifficulty difficulty;
     
-    // Evaluate board position (positive = good for AI/white, negative = bad)
-    int evaluatePosition(int board[8][8]);
+    // Side the AI is searching for (the player to move when a search starts)
+    int aiPlayer;
+    
+    // Multi-ProbCut selective search settings
+    bool probCutEnabled;
+    double probCutConfidence;
+    
+    // Time budget for iterative deepening (Expert) and Monte-Carlo search
+    int timeBudgetMs;
+    
+    // Monte-Carlo search threads (the calling thread included)
+    int threadCount;
+    std::chrono::steady_clock::time_point searchDeadline;
+    bool useDeadline;
+    bool searchAborted;
+    
+    // External request to stop the running search (owned by the caller, may be null)
+    const std::atomic<bool>* stopSignal;
+    
+    // Search statistics
+    uint64_t nodeCount;
+    int lastSearchDepth;
+    
+    // Transposition table (shared across iterations and moves)
+    std::vector<TTEntry> transpositionTable;
+    
+    // Current search uses Multi-ProbCut (cached entries were produced the same way)
+    bool selectiveSearch;
+    
+    // Random choices for the lower difficulties (per instance, so AIs can run on separate threads)
+    std::mt19937 rng;
+    
+    // Network replacing the table evaluation (owned by the caller, may be null; 8x8 only)
+    const NeuralEvaluator* neuralEvaluator;
+    
+    // Debug mode: recompute the features at every node and count disagreements
+    bool checkFeatures;
+    uint64_t featureMismatches;
+    
+    // Exact solver for the last iteration (boards of up to 64 squares; created on first use)
+    std::unique_ptr<BasicSolver<N>> solver;
+    int solverTableBits;
+    
+    // Exact results kept across sessions (owned by the caller, may be null)
+    BasicSolvedStore<N>* solvedStore;
+    
+    // Monte-Carlo search, its node arena reused by every move (boards of up to 64 squares;
+    // created on first use)
+    std::unique_ptr<BasicMCTS<N>> mcts;
+    
+    // Evaluate board position from Player's point of view (positive = good for Player)
+    template <int Player>
+    int evaluatePosition(int board[N][N], const EvalFeatures& features);
+    
+    // Final disc margin for a finished game from Player's point of view, scaled above any heuristic score
+    template <int Player>
+    int finalScore(const EvalFeatures& features);
+    
+    // Features of a board from scratch
+    void computeFeatures(int board[N][N], EvalFeatures& features);
+    
+    // Compare incrementally updated features with a full recomputation (feature check mode)
+    void verifyFeatures(int board[N][N], const EvalFeatures& features);
     
     // Count mobility (number of valid moves)
     int countMobility(int player);
@@ -34,7 +155,7 @@ private:
     bool isEdge(int row, int col);
     
     // Get corner mobility (prioritize corners)
-    int getCornerMobility(int board[8][8]);
+    int getCornerMobility(int board[N][N]);
     
     // Easy: Random valid move
     std::pair<int, int> getEasyMove();
@@ -42,30 +163,166 @@ private:
     // Medium: Greedy - maximize immediate pieces flipped
     std::pair<int, int> getMediumMove();
     
-    // Hard: Minimax with depth 3
+    // Hard: Minimax with Alpha-Beta pruning, fixed depth
     std::pair<int, int> getHardMove();
     
-    // Expert: Minimax with Alpha-Beta pruning and depth 5-6
+    // Expert: Iterative deepening with Multi-ProbCut under a time budget
     std::pair<int, int> getExpertMove();
     
-    // Minimax algorithm
-    int minimax(int board[8][8], int depth, int alpha, int beta, bool maximizingPlayer);
+    // Monte-Carlo: most visited move after the time budget (Expert on boards over 64 squares)
+    std::pair<int, int> getMctsMove();
+    
+    // Negamax with alpha-beta pruning; Player is the side to move and scores are from its point of view.
+    // Specialized per colour so the inner loops carry no side-to-move branches.
+    template <int Player>
+    int negamax(int board[N][N], const EvalFeatures& features, int depth, int alpha, int beta);
+    
+    // Dispatch to the negamax specialization for `player` (computes the board's features)
+    int search(int board[N][N], int player, int depth, int alpha, int beta);
+    
+    // Multi-ProbCut test: returns true and sets cutValue if the node can be cut
+    template <int Player>
+    bool tryProbCut(int board[N][N], const EvalFeatures& features, int depth, int alpha, int beta, int* cutValue);
     
     // Copy board state
-    void copyBoard(int src[8][8], int dest[8][8]);
+    void copyBoard(int src[N][N], int dest[N][N]);
+    
+    // Check if a move is valid for Player on a search board
+    template <int Player>
+    bool isValidMoveOn(int board[N][N], int row, int col);
+    
+    // Place a piece for Player and flip captured discs; returns number of flipped discs
+    template <int Player>
+    int applyMove(int board[N][N], int row, int col);
+    int applyMove(int board[N][N], int row, int col, int player);
+    
+    // Same, also updating `features` from the placed and flipped discs
+    template <int Player>
+    void applyMove(int board[N][N], int row, int col, EvalFeatures& features);
+    
+    // Get all valid moves for Player on a search board
+    template <int Player>
+    std::vector<std::pair<int, int>> generateMoves(int board[N][N]);
+    std::vector<std::pair<int, int>> generateMoves(int board[N][N], int player);
+    
+    // Count discs on a search board
+    int countDiscs(int board[N][N]);
+    
+    // Zobrist hash of a search board with Player to move
+    template <int Player>
+    uint64_t hashBoard(int board[N][N]);
+    
+    // Transposition table access
+    TTEntry* probeTT(uint64_t key);
+    void storeTT(uint64_t key, int value, int depth, TTBound bound, int bestMove);
+    
+    // Check the time budget (only every few thousand nodes)
+    bool checkDeadline();
+    
+    // Start a search for the side to move
+    void beginSearch(bool selective);
+    
+    // One iteration at the root: scores `moves` to `depth`, the best `moveCount` exactly
+    // (the rest only as upper bounds), and reorders them best first.
+    // Returns false if the search was aborted.
+    bool searchRoot(int board[N][N], std::vector<std::pair<int, int>>& moves,
+                    std::vector<AnalyzedMove>& ranked, int depth, int moveCount);
+    
+    // The iteration that reaches the end of the game, on the bitboard solver where the board
+    // fits one (searchRoot otherwise). Same results as searchRoot, in final disc margins.
+    bool solveRoot(int board[N][N], std::vector<std::pair<int, int>>& moves,
+                   std::vector<AnalyzedMove>& ranked, int moveCount);
+    
+    // Ranking of the root from the solved-position store: the stored move exactly, the others
+    // bounded by its score. Returns false if the position is not stored.
+    bool storedRoot(int board[N][N], std::vector<std::pair<int, int>>& moves, std::vector<AnalyzedMove>& ranked);
+    
+    // Sort scored root moves best first and search them first in the next iteration
+    void rankRoot(std::vector<std::pair<int, int>>& moves, std::vector<AnalyzedMove>& ranked, int moveCount);
 
 public:
-    AI(GameEngine* gameEngine);
-    ~AI();
+    BasicAI(BasicGameEngine<N>* gameEngine);
+    ~BasicAI();
     
     // Set AI difficulty
     void setDifficulty(AIDifficulty diff);
     
+    // Enable/disable Multi-ProbCut in the Expert search
+    void setProbCutEnabled(bool enabled);
+    
+    // Cut confidence in multiples of sigma (higher = fewer, safer cuts)
+    void setProbCutConfidence(double confidence);
+    
+    // Time budget per Expert or Monte-Carlo move in milliseconds
+    void setTimeBudget(int milliseconds);
+    
+    // Threads for the Monte-Carlo search (default: one per core)
+    void setThreadCount(int threads);
+    
+    // Seed the random move choices (for reproducible games)
+    void setSeed(uint32_t seed);
+    
+    // Evaluate leaves with a loaded network instead of the position table (null restores the
+    // table). Ignored on boards the network is not defined for; disables Multi-ProbCut, whose
+    // parameters were fitted for the table evaluation.
+    void setNeuralEvaluator(const NeuralEvaluator* evaluator);
+    
+    // Keep exact endgame results in `store` (null detaches): positions are looked up there
+    // before they are solved, and every new solve is added. Ignored on boards over 64 squares.
+    void setSolvedStore(BasicSolvedStore<N>* store);
+    
+    // Size of the exact solver's table (log2 of the entry count). Defaults to the small
+    // mobile table; host tools can afford SOLVER_TABLE_BITS.
+    void setSolverTableBits(int bits);
+    
+    // Static evaluation of a position from `player`'s point of view (for analysis tools)
+    int evaluateBoard(int board[N][N], int player);
+    
+    // Debug mode: check the incrementally updated evaluation features against a full
+    // recomputation at every search node (slow)
+    void setFeatureCheck(bool enabled);
+    
+    // Nodes whose features disagreed with the recomputation since the check was enabled
+    uint64_t getFeatureMismatchCount() const;
+    
     // Get the best move for the AI (returns row, col)
     std::pair<int, int> getBestMove();
     
+    // Search a position to a fixed depth without a time limit (for analysis tools).
+    // Returns the score from `player`'s point of view.
+    int searchPosition(int board[N][N], int player, int depth, bool selective);
+    
+    // Iterative-deepening analysis of the engine's position for external tools. Ranks the best
+    // `moveCount` moves exactly, up to `maxDepth` plies or `timeMs` milliseconds (0 = no limit),
+    // and returns the last completed iteration early once `stop` (if given) becomes true.
+    // `onIteration` (if set) sees every completed iteration.
+    AnalysisResult analyze(int maxDepth, int timeMs, int moveCount, const std::atomic<bool>* stop,
+                           const std::function<void(const AnalysisResult&)>& onIteration);
+    
+    // Search score in discs: exact for proven results, a rough scale for heuristic scores
+    static double scoreInDiscs(int score);
+    
+    // Nodes visited by the last search (playouts for Monte-Carlo)
+    uint64_t getNodeCount() const;
+    
+    // Deepest fully completed iteration of the last Expert search
+    int getLastSearchDepth() const;
+    
+    // Drop all cached search results
+    void clearCache();
+    
+    // Write settings (and optionally the transposition table) to a snapshot
+    void writeSnapshot(SnapshotWriter& writer, bool includeCaches);
+    
+    // Restore from a snapshot - returns false (state unchanged) if the data is invalid or
+    // anything follows the AI's section (the last one)
+    bool readSnapshot(SnapshotReader& reader);
+    
     // Get difficulty name
     static const char* getDifficultyName(AIDifficulty diff);
 };
 
+// Standard 8x8 AI (the app's opponent)
+using AI = BasicAI<8>;
+
 #endif // REVERSI_AI_H
@@ -0,0 +1,94 @@
+#ifndef REVERSI_BITBOARD_H
+#define REVERSI_BITBOARD_H
+
+#include "GameEngine.h"
+#include <cstdint>
+
+// Move generation on bitboards for boards of up to 64 squares (bit row * N + col).
+// Shift masks and loop bounds are compile-time constants per size.
+template <int N>
+struct Bitboard {
+    static_assert(N * N <= 64, "bitboards hold at most 64 squares");
+    
+    static constexpr uint64_t ALL = (N * N == 64) ? ~0ULL : (1ULL << (N * N)) - 1;
+    
+    static constexpr uint64_t square(int row, int col) {
+        return 1ULL << (row * N + col);
+    }
+    
+    static constexpr uint64_t column(int col) {
+        uint64_t mask = 0;
+        for (int row = 0; row < N; row++) {
+            mask |= square(row, col);
+        }
+        return mask;
+    }
+    
+    static constexpr uint64_t NOT_FIRST_COL = ALL & ~column(0);
+    static constexpr uint64_t NOT_LAST_COL = ALL & ~column(N - 1);
+    static constexpr uint64_t CORNERS = square(0, 0) | square(0, N - 1) |
+                                        square(N - 1, 0) | square(N - 1, N - 1);
+    static constexpr uint64_t X_SQUARES = square(1, 1) | square(1, N - 2) |
+                                          square(N - 2, 1) | square(N - 2, N - 2);
+    
+    static int popCount(uint64_t discs) {
+        return __builtin_popcountll(discs);
+    }
+    
+    // Move every disc one step in direction `dir` (0-7), dropping discs that leave the board
+    static uint64_t shift(uint64_t discs, int dir) {
+        switch (dir) {
+            case 0: return (discs << 1) & NOT_FIRST_COL;            // east
+            case 1: return (discs >> 1) & NOT_LAST_COL;             // west
+            case 2: return (discs << N) & ALL;                      // south
+            case 3: return discs >> N;                              // north
+            case 4: return (discs << (N + 1)) & NOT_FIRST_COL;      // south-east
+            case 5: return (discs << (N - 1)) & NOT_LAST_COL;       // south-west
+            case 6: return (discs >> (N - 1)) & NOT_FIRST_COL;      // north-east
+            default: return (discs >> (N + 1)) & NOT_LAST_COL;      // north-west
+        }
+    }
+    
+    // Legal moves for the side owning `player`
+    static uint64_t legalMoves(uint64_t player, uint64_t opponent) {
+        uint64_t empty = ~(player | opponent) & ALL;
+        uint64_t moves = 0;
+        for (int dir = 0; dir < 8; dir++) {
+            // Runs of opponent discs adjacent to ours, extended up to the longest possible run
+            uint64_t run = shift(player, dir) & opponent;
+            for (int i = 0; i < N - 3; i++) {
+                run |= shift(run, dir) & opponent;
+            }
+            moves |= shift(run, dir) & empty;
+        }
+        return moves;
+    }
+    
+    // Discs flipped by playing `square`
+    static uint64_t flips(uint64_t player, uint64_t opponent, int square) {
+        uint64_t flipped = 0;
+        uint64_t origin = 1ULL << square;
+        for (int dir = 0; dir < 8; dir++) {
+            uint64_t run = 0;
+            uint64_t cursor = shift(origin, dir);
+            while (cursor & opponent) {
+                run |= cursor;
+                cursor = shift(cursor, dir);
+            }
+            if (cursor & player) flipped |= run;
+        }
+        return flipped;
+    }
+    
+    // Pack an N * N board (0=empty, 1=black, 2=white) into the discs of `player` and its opponent
+    static void fromBoard(const int* board, int player, uint64_t* own, uint64_t* other) {
+        *own = 0;
+        *other = 0;
+        for (int i = 0; i < N * N; i++) {
+            if (board[i] == player) *own |= 1ULL << i;
+            else if (board[i] == opponentOf(player)) *other |= 1ULL << i;
+        }
+    }
+};
+
+#endif // REVERSI_BITBOARD_H
@@ -1,31 +1,39 @@
 #include "GameEngine.h"
+#include "Snapshot.h"
+#include "Trace.h"
 #include <algorithm>
 #include <cstring>
 
-GameEngine::GameEngine() : currentPlayer(BLACK), blackScore(0), whiteScore(0), historyIndex(-1) {
+template <int N>
+BasicGameEngine<N>::BasicGameEngine() : currentPlayer(BLACK), historyIndex(-1), lastMoveRow(-1), lastMoveCol(-1), blackScore(0), whiteScore(0), emptyCount(0), winner(-1) {
     initializeBoard();
 }
 
-GameEngine::~GameEngine() {
+template <int N>
+BasicGameEngine<N>::~BasicGameEngine() {
     history.clear();
 }
 
-void GameEngine::initializeBoard() {
+template <int N>
+void BasicGameEngine<N>::initializeBoard() {
     // Clear board
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
             board[i][j] = EMPTY;
         }
     }
     
     // Set starting position (center 4 cells)
-    board[3][3] = WHITE;
-    board[3][4] = BLACK;
-    board[4][3] = BLACK;
-    board[4][4] = WHITE;
+    constexpr int center = N / 2;
+    board[center - 1][center - 1] = WHITE;
+    board[center - 1][center] = BLACK;
+    board[center][center - 1] = BLACK;
+    board[center][center] = WHITE;
     
     currentPlayer = BLACK;
-    updateScores();
+    lastMoveRow = -1;
+    lastMoveCol = -1;
+    refreshStatus();
     
     // Clear history
     history.clear();
@@ -33,19 +41,18 @@ void GameEngine::initializeBoard() {
     saveState();
 }
 
-bool GameEngine::isValidMove(int row, int col, int player) {
-    // Check bounds and if cell is empty
-    if (row < 0 || row >= 8 || col < 0 || col >= 8) return false;
-    if (board[row][col] != EMPTY) return false;
-    
-    // Check if this move would flip any pieces
-    auto flippable = getFlippablePieces(row, col, player);
-    return !flippable.empty();
+template <int N>
+bool BasicGameEngine<N>::isValidMove(int row, int col, int player) {
+    // Check bounds, then the cached move table
+    if (row < 0 || row >= N || col < 0 || col >= N) return false;
+    if (player != BLACK && player != WHITE) return false;
+    return legalMoves[player][row][col];
 }
 
-std::vector<std::pair<int, int>> GameEngine::getFlippablePieces(int row, int col, int player) {
+template <int N>
+std::vector<std::pair<int, int>> BasicGameEngine<N>::getFlippablePieces(int row, int col, int player) {
     std::vector<std::pair<int, int>> flippable;
-    int opponent = (player == BLACK) ? WHITE : BLACK;
+    int opponent = opponentOf(player);
     
     // Check all 8 directions
     for (int d = 0; d < 8; d++) {
@@ -57,7 +64,7 @@ std::vector<std::pair<int, int>> GameEngine::getFlippablePieces(int row, int col
         int c = col + dc;
         
         // Traverse in this direction
-        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+        while (r >= 0 && r < N && c >= 0 && c < N) {
             if (board[r][c] == opponent) {
                 potentialFlips.push_back({r, c});
             } else if (board[r][c] == player) {
@@ -78,39 +85,83 @@ std::vector<std::pair<int, int>> GameEngine::getFlippablePieces(int row, int col
     return flippable;
 }
 
-void GameEngine::flipPieces(const std::vector<std::pair<int, int>>& pieces) {
+template <int N>
+void BasicGameEngine<N>::flipPieces(const std::vector<std::pair<int, int>>& pieces) {
     for (const auto& piece : pieces) {
         board[piece.first][piece.second] = currentPlayer;
     }
 }
 
-void GameEngine::updateScores() {
+template <int N>
+void BasicGameEngine<N>::refreshStatus() {
     blackScore = 0;
     whiteScore = 0;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (board[i][j] == BLACK) blackScore++;
-            else if (board[i][j] == WHITE) whiteScore++;
+    emptyCount = 0;
+    moveCounts[EMPTY] = moveCounts[BLACK] = moveCounts[WHITE] = 0;
+    
+    // One pass finds the scores and both sides' moves
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            int movers = 0;
+            if (board[i][j] == BLACK) {
+                blackScore++;
+            } else if (board[i][j] == WHITE) {
+                whiteScore++;
+            } else {
+                emptyCount++;
+                movers = moversAt<N>(board, i, j);
+            }
+            legalMoves[EMPTY][i][j] = false;
+            legalMoves[BLACK][i][j] = (movers >> BLACK) & 1;
+            legalMoves[WHITE][i][j] = (movers >> WHITE) & 1;
+            moveCounts[BLACK] += (movers >> BLACK) & 1;
+            moveCounts[WHITE] += (movers >> WHITE) & 1;
         }
     }
+    
+    // The game ends when neither side can move (which includes a full board)
+    if (moveCounts[BLACK] > 0 || moveCounts[WHITE] > 0) {
+        winner = -1;
+    } else if (blackScore != whiteScore) {
+        winner = (blackScore > whiteScore) ? BLACK : WHITE;
+    } else {
+        winner = 0;
+    }
 }
 
-bool GameEngine::hasValidMoves(int player) {
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (isValidMove(i, j, player)) {
-                return true;
-            }
-        }
-    }
-    return false;
+template <int N>
+bool BasicGameEngine<N>::hasValidMoves(int player) {
+    if (player != BLACK && player != WHITE) return false;
+    return moveCounts[player] > 0;
 }
 
-void GameEngine::initGame() {
+template <int N>
+void BasicGameEngine<N>::initGame() {
     initializeBoard();
 }
 
-bool GameEngine::makeMove(int row, int col, int player) {
+template <int N>
+bool BasicGameEngine<N>::setPosition(const int* boardIn, int player) {
+    if (player != BLACK && player != WHITE) return false;
+    for (int i = 0; i < N * N; i++) {
+        if (boardIn[i] != EMPTY && boardIn[i] != BLACK && boardIn[i] != WHITE) return false;
+    }
+    
+    std::memcpy(board, boardIn, N * N * sizeof(int));
+    currentPlayer = player;
+    lastMoveRow = -1;
+    lastMoveCol = -1;
+    refreshStatus();
+    
+    history.clear();
+    historyIndex = -1;
+    saveState();
+    return true;
+}
+
+template <int N>
+bool BasicGameEngine<N>::makeMove(int row, int col, int player) {
+    TRACE_SCOPE("GameEngine::makeMove");
     if (!isValidMove(row, col, player)) {
         return false;
     }
@@ -126,141 +177,229 @@ bool GameEngine::makeMove(int row, int col, int player) {
     flipPieces(flippable);
     
     // Update scores
-    updateScores();
+    refreshStatus();
+    
+    lastMoveRow = row;
+    lastMoveCol = col;
     
     // Switch player
-    currentPlayer = (player == BLACK) ? WHITE : BLACK;
+    currentPlayer = opponentOf(player);
     
     return true;
 }
 
-bool GameEngine::canMove(int row, int col, int player) {
+template <int N>
+bool BasicGameEngine<N>::canMove(int row, int col, int player) {
     return isValidMove(row, col, player);
 }
 
-bool GameEngine::playerCanMove(int player) {
+template <int N>
+bool BasicGameEngine<N>::playerCanMove(int player) {
     return hasValidMoves(player);
 }
 
-void GameEngine::passTurn() {
+template <int N>
+void BasicGameEngine<N>::passTurn() {
+    // The board is unchanged, so the cached status still holds
     saveState();
-    currentPlayer = (currentPlayer == BLACK) ? WHITE : BLACK;
+    currentPlayer = opponentOf(currentPlayer);
 }
 
-void GameEngine::getBoardState(int* boardOut) {
-    std::memcpy(boardOut, board, 64 * sizeof(int));
+template <int N>
+void BasicGameEngine<N>::getBoardState(int* boardOut) {
+    std::memcpy(boardOut, board, N * N * sizeof(int));
 }
 
-void GameEngine::getScores(int* blackScoreOut, int* whiteScoreOut) {
+template <int N>
+void BasicGameEngine<N>::getScores(int* blackScoreOut, int* whiteScoreOut) {
     *blackScoreOut = blackScore;
     *whiteScoreOut = whiteScore;
 }
 
-int GameEngine::getCurrentPlayer() {
+template <int N>
+int BasicGameEngine<N>::getCurrentPlayer() {
     return currentPlayer;
 }
 
-void GameEngine::setCurrentPlayer(int player) {
+template <int N>
+void BasicGameEngine<N>::setCurrentPlayer(int player) {
     currentPlayer = player;
 }
 
-void GameEngine::saveState() {
+template <int N>
+void BasicGameEngine<N>::saveState() {
     // Remove any states after current index (for redo)
     if (historyIndex < (int)history.size() - 1) {
         history.resize(historyIndex + 1);
     }
     
-    GameState state;
-    std::memcpy(state.board, board, 64 * sizeof(int));
+    BasicGameState<N> state;
+    std::memcpy(state.board, board, N * N * sizeof(int));
     state.currentPlayer = currentPlayer;
     state.blackScore = blackScore;
     state.whiteScore = whiteScore;
+    state.lastMoveRow = lastMoveRow;
+    state.lastMoveCol = lastMoveCol;
     
     history.push_back(state);
     historyIndex++;
 }
 
-bool GameEngine::undo() {
+template <int N>
+bool BasicGameEngine<N>::undo() {
+    TRACE_SCOPE("GameEngine::undo");
     if (historyIndex <= 0) return false;
     
     historyIndex--;
-    GameState& state = history[historyIndex];
-    std::memcpy(board, state.board, 64 * sizeof(int));
+    BasicGameState<N>& state = history[historyIndex];
+    std::memcpy(board, state.board, N * N * sizeof(int));
     currentPlayer = state.currentPlayer;
-    blackScore = state.blackScore;
-    whiteScore = state.whiteScore;
+    lastMoveRow = state.lastMoveRow;
+    lastMoveCol = state.lastMoveCol;
+    refreshStatus();
     
     return true;
 }
 
-bool GameEngine::redo() {
+template <int N>
+bool BasicGameEngine<N>::redo() {
+    TRACE_SCOPE("GameEngine::redo");
     if (historyIndex >= (int)history.size() - 1) return false;
     
     historyIndex++;
-    GameState& state = history[historyIndex];
-    std::memcpy(board, state.board, 64 * sizeof(int));
+    BasicGameState<N>& state = history[historyIndex];
+    std::memcpy(board, state.board, N * N * sizeof(int));
     currentPlayer = state.currentPlayer;
-    blackScore = state.blackScore;
-    whiteScore = state.whiteScore;
+    lastMoveRow = state.lastMoveRow;
+    lastMoveCol = state.lastMoveCol;
+    refreshStatus();
     
     return true;
 }
 
-bool GameEngine::canUndo() {
+template <int N>
+bool BasicGameEngine<N>::canUndo() {
     return historyIndex > 0;
 }
 
-bool GameEngine::canRedo() {
+template <int N>
+bool BasicGameEngine<N>::canRedo() {
     return historyIndex < (int)history.size() - 1;
 }
 
-bool GameEngine::isGameOver() {
-    // Check if board is full
-    bool boardFull = true;
-    for (int i = 0; i < 8 && boardFull; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (board[i][j] == EMPTY) {
-                boardFull = false;
-                break;
-            }
-        }
-    }
-    
-    if (boardFull) return true;
-    
-    // Check if neither player can move
-    return !hasValidMoves(BLACK) && !hasValidMoves(WHITE);
+template <int N>
+bool BasicGameEngine<N>::isGameOver() {
+    return winner >= 0;
 }
 
-int GameEngine::getWinner() {
-    if (!isGameOver()) return -1;
-    
-    if (blackScore > whiteScore) return BLACK;
-    if (whiteScore > blackScore) return WHITE;
-    return 0; // Draw
+template <int N>
+int BasicGameEngine<N>::getEmptyCount() {
+    return emptyCount;
 }
 
-void GameEngine::getLastMove(int* row, int* col) {
-    // Find the last move from history
-    if (historyIndex > 0) {
-        // The move was made to reach current state, so look at the difference
-        // For simplicity, we'll track this separately if needed
-        *row = -1;
-        *col = -1;
-    } else {
-        *row = -1;
-        *col = -1;
-    }
+template <int N>
+int BasicGameEngine<N>::getWinner() {
+    return winner;
 }
 
-std::vector<std::pair<int, int>> GameEngine::getValidMoves(int player) {
+template <int N>
+void BasicGameEngine<N>::getLastMove(int* row, int* col) {
+    *row = lastMoveRow;
+    *col = lastMoveCol;
+}
+
+template <int N>
+std::vector<std::pair<int, int>> BasicGameEngine<N>::getValidMoves(int player) {
     std::vector<std::pair<int, int>> moves;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            if (isValidMove(i, j, player)) {
+    if (player != BLACK && player != WHITE) return moves;
+    moves.reserve(moveCounts[player]);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            if (legalMoves[player][i][j]) {
                 moves.push_back({i, j});
             }
         }
     }
     return moves;
 }
+
+template <int N>
+void BasicGameEngine<N>::writeSnapshot(SnapshotWriter& writer) {
+    writer.writeBoard(&board[0][0], N * N);
+    writer.writeU8(static_cast<uint8_t>(currentPlayer));
+    writer.writeI8(static_cast<int8_t>(lastMoveRow));
+    writer.writeI8(static_cast<int8_t>(lastMoveCol));
+    
+    writer.writeU16(static_cast<uint16_t>(history.size()));
+    writer.writeU16(static_cast<uint16_t>(historyIndex));
+    for (const auto& state : history) {
+        writer.writeBoard(&state.board[0][0], N * N);
+        writer.writeU8(static_cast<uint8_t>(state.currentPlayer));
+        writer.writeU8(static_cast<uint8_t>(state.blackScore));
+        writer.writeU8(static_cast<uint8_t>(state.whiteScore));
+        writer.writeI8(static_cast<int8_t>(state.lastMoveRow));
+        writer.writeI8(static_cast<int8_t>(state.lastMoveCol));
+    }
+}
+
+template <int N>
+bool BasicGameEngine<N>::readSnapshot(SnapshotReader& reader) {
+    // Parse everything before touching the live state
+    int newBoard[N][N];
+    uint8_t player;
+    int8_t moveRow, moveCol;
+    uint16_t count, index;
+    if (!reader.readBoard(&newBoard[0][0], N * N) || !reader.readU8(&player) ||
+        !reader.readI8(&moveRow) || !reader.readI8(&moveCol) ||
+        !reader.readU16(&count) || !reader.readU16(&index)) {
+        return false;
+    }
+    if ((player != BLACK && player != WHITE) || count == 0 || index >= count) return false;
+    if (moveRow < -1 || moveRow >= N || moveCol < -1 || moveCol >= N || (moveRow < 0) != (moveCol < 0)) return false;
+    
+    std::vector<BasicGameState<N>> newHistory(count);
+    for (auto& state : newHistory) {
+        uint8_t statePlayer, stateBlack, stateWhite;
+        int8_t lastRow, lastCol;
+        if (!reader.readBoard(&state.board[0][0], N * N) || !reader.readU8(&statePlayer) ||
+            !reader.readU8(&stateBlack) || !reader.readU8(&stateWhite) ||
+            !reader.readI8(&lastRow) || !reader.readI8(&lastCol)) {
+            return false;
+        }
+        if (statePlayer != BLACK && statePlayer != WHITE) return false;
+        if (lastRow < -1 || lastRow >= N || lastCol < -1 || lastCol >= N || (lastRow < 0) != (lastCol < 0)) return false;
+        state.currentPlayer = statePlayer;
+        
+        // The stored scores are redundant; count them from the board (readBoard has checked every square)
+        state.blackScore = 0;
+        state.whiteScore = 0;
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                if (state.board[i][j] == BLACK) {
+                    state.blackScore++;
+                } else if (state.board[i][j] == WHITE) {
+                    state.whiteScore++;
+                }
+            }
+        }
+        state.lastMoveRow = lastRow;
+        state.lastMoveCol = lastCol;
+    }
+    
+    std::memcpy(board, newBoard, N * N * sizeof(int));
+    currentPlayer = player;
+    history.swap(newHistory);
+    historyIndex = index;
+    lastMoveRow = moveRow;
+    lastMoveCol = moveCol;
+    
+    // Scores and status are derived from the board
+    refreshStatus();
+    
+    return true;
+}
+
+// Supported board sizes
+template class BasicGameEngine<6>;
+template class BasicGameEngine<8>;
+template class BasicGameEngine<10>;
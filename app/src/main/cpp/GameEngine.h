@@ -3,15 +3,25 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+
+class SnapshotWriter;
+class SnapshotReader;
 
 // Player constants
 constexpr int EMPTY = 0;
 constexpr int BLACK = 1;
 constexpr int WHITE = 2;
 
+// Opponent of BLACK or WHITE (arithmetic, so no colour branch)
+constexpr int opponentOf(int player) {
+    return BLACK + WHITE - player;
+}
+
 // Game state structure for history
-struct GameState {
-    int board[8][8];
+template <int N>
+struct BasicGameState {
+    int board[N][N];
     int currentPlayer;
     int blackScore;
     int whiteScore;
@@ -26,13 +36,48 @@ const int DIRECTIONS[8][2] = {
     {1, -1},  {1, 0},  {1, 1}
 };
 
-class GameEngine {
+// Bit mask of the players (1 << BLACK, 1 << WHITE) with a legal move on the empty square (row, col).
+// A single scan serves both colours: a run of one colour closed by the other is a move for the latter.
+template <int N>
+inline int moversAt(const int board[N][N], int row, int col) {
+    int movers = 0;
+    for (int d = 0; d < 8; d++) {
+        int dr = DIRECTIONS[d][0];
+        int dc = DIRECTIONS[d][1];
+        int r = row + dr;
+        int c = col + dc;
+        if (r < 0 || r >= N || c < 0 || c >= N || board[r][c] == EMPTY) continue;
+        
+        int run = board[r][c];
+        do {
+            r += dr;
+            c += dc;
+        } while (r >= 0 && r < N && c >= 0 && c < N && board[r][c] == run);
+        
+        if (r >= 0 && r < N && c >= 0 && c < N && board[r][c] == opponentOf(run)) {
+            movers |= 1 << opponentOf(run);
+            if (movers == ((1 << BLACK) | (1 << WHITE))) break;
+        }
+    }
+    return movers;
+}
+
+// Reversi on an N x N board. Storage and loop bounds are compile-time constants per size;
+// the supported sizes (6, 8, 10) are instantiated in GameEngine.cpp.
+template <int N>
+class BasicGameEngine {
+    static_assert(N >= 4 && N <= 10 && N % 2 == 0, "board size must be even, 4 to 10");
+
 private:
-    int board[8][8];
+    int board[N][N];
     int currentPlayer;
-    std::vector<GameState> history;
+    std::vector<BasicGameState<N>> history;
     int historyIndex;
     
+    // Move that produced the current board (-1 if none)
+    int lastMoveRow;
+    int lastMoveCol;
+    
     // Initialize the board with starting position
     void initializeBoard();
     
@@ -48,19 +93,32 @@ private:
     // Check if player has any valid moves
     bool hasValidMoves(int player);
     
-    // Count scores
-    void updateScores();
+    // Recompute scores, legal moves and game status from the board. Called once per board
+    // change so the status queries the UI polls after every move are O(1).
+    void refreshStatus();
     
     int blackScore;
     int whiteScore;
+    
+    // Cached status (see refreshStatus); move tables are indexed by player
+    bool legalMoves[3][N][N];
+    int moveCounts[3];
+    int emptyCount;
+    int winner;
 
 public:
-    GameEngine();
-    ~GameEngine();
+    static constexpr int SIZE = N;
+    
+    BasicGameEngine();
+    ~BasicGameEngine();
     
     // Initialize/Reset game
     void initGame();
     
+    // Start from an arbitrary position (N * N squares, 0=empty, 1=black, 2=white) with
+    // `player` to move; clears the history. Returns false (state unchanged) if it is invalid.
+    bool setPosition(const int* boardIn, int player);
+    
     // Player move - returns true if move was successful
     bool makeMove(int row, int col, int player);
     
@@ -100,6 +158,9 @@ public:
     // Check if game is over
     bool isGameOver();
     
+    // Number of empty squares
+    int getEmptyCount();
+    
     // Get winner (-1 = no winner yet, 0 = draw, 1 = black, 2 = white)
     int getWinner();
     
@@ -111,6 +172,31 @@ public:
     
     // Get all valid moves for a player
     std::vector<std::pair<int, int>> getValidMoves(int player);
+    
+    // Get valid moves as a bitmask (bit row * N + col); boards up to 8x8 only
+    template <int Size = N>
+    uint64_t getValidMoveMask(int player) {
+        static_assert(Size * Size <= 64, "move mask holds at most 64 squares");
+        uint64_t mask = 0;
+        if (player != BLACK && player != WHITE) return mask;
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                if (legalMoves[player][i][j]) {
+                    mask |= 1ULL << (i * N + j);
+                }
+            }
+        }
+        return mask;
+    }
+    
+    // Write board, side to move and undo/redo history to a snapshot
+    void writeSnapshot(SnapshotWriter& writer);
+    
+    // Restore from a snapshot - returns false (state unchanged) if the data is invalid
+    bool readSnapshot(SnapshotReader& reader);
 };
 
+// Standard 8x8 game (the app's board)
+using GameEngine = BasicGameEngine<8>;
+
 #endif // REVERSI_GAMEENGINE_H
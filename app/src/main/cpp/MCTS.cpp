@@ -0,0 +1,277 @@
+#include "MCTS.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Negative Node::firstChild states
+constexpr int32_t LEAF = -1;            // not expanded yet
+constexpr int32_t EXPANDING = -2;       // another thread is creating the children
+constexpr int32_t TERMINAL = -3;        // neither side can move
+constexpr int32_t ARENA_FULL = -4;      // stays a leaf: no room for children
+
+// A leaf is expanded on this visit (the first visits only run playouts)
+constexpr int32_t EXPAND_VISITS = 2;
+
+// UCT exploration constant (results are scaled to 0..1)
+constexpr double EXPLORATION = 1.0;
+
+// Check the clock once every this many playouts per thread
+constexpr uint64_t CLOCK_CHECK_INTERVAL = 16;
+
+// Light playout policy: take a corner when one is available, avoid X-squares when possible
+template <int N>
+uint64_t preferredMoves(uint64_t moves) {
+    uint64_t corners = moves & Bitboard<N>::CORNERS;
+    if (corners != 0) return corners;
+    uint64_t safe = moves & ~Bitboard<N>::X_SQUARES;
+    return (safe != 0) ? safe : moves;
+}
+
+} // namespace
+
+template <int N>
+BasicMCTS<N>::BasicMCTS(int nodeCapacity)
+    : arena(new Node[nodeCapacity]), capacity(nodeCapacity), nodesUsed(0), rootPlayer(0), rootOpponent(0),
+      finished(false), playouts(0), seed(0x2545F4914F6CDD1DULL) {
+    // Declared for every size so BasicAI can hold one; only bitboard sizes can be built
+    static_assert(N * N <= 64, "bitboard playouts need at most 64 squares");
+}
+
+template <int N>
+void BasicMCTS<N>::setSeed(uint64_t value) {
+    seed = value;
+}
+
+template <int N>
+int32_t BasicMCTS<N>::allocate(int count) {
+    int32_t first = nodesUsed.fetch_add(count, std::memory_order_relaxed);
+    return (first + count <= capacity) ? first : -1;
+}
+
+template <int N>
+void BasicMCTS<N>::expand(int32_t index, uint64_t player, uint64_t opponent) {
+    Node& node = arena[index];
+    uint64_t moves = Bitboard<N>::legalMoves(player, opponent);
+    
+    int count;
+    if (moves != 0) {
+        count = Bitboard<N>::popCount(moves);
+    } else if (Bitboard<N>::legalMoves(opponent, player) != 0) {
+        count = 1;  // pass
+    } else {
+        node.firstChild.store(TERMINAL, std::memory_order_release);
+        return;
+    }
+    
+    int32_t first = allocate(count);
+    if (first < 0) {
+        node.firstChild.store(ARENA_FULL, std::memory_order_release);
+        return;
+    }
+    
+    int32_t next = first;
+    auto addChild = [this, &next](int move) {
+        Node& child = arena[next++];
+        child.visits.store(0, std::memory_order_relaxed);
+        child.score.store(0, std::memory_order_relaxed);
+        child.firstChild.store(LEAF, std::memory_order_relaxed);
+        child.childCount = 0;
+        child.move = static_cast<int8_t>(move);
+    };
+    
+    if (moves == 0) {
+        addChild(-1);
+    } else {
+        // Prior order for the first visits: corners, then ordinary squares, X-squares last
+        uint64_t corners = moves & Bitboard<N>::CORNERS;
+        uint64_t xSquares = moves & Bitboard<N>::X_SQUARES;
+        uint64_t groups[3] = {corners, moves & ~corners & ~xSquares, xSquares};
+        for (uint64_t group : groups) {
+            for (; group != 0; group &= group - 1) {
+                addChild(__builtin_ctzll(group));
+            }
+        }
+    }
+    
+    // Publish the children (readers acquire firstChild before touching them)
+    node.childCount = static_cast<int16_t>(count);
+    node.firstChild.store(first, std::memory_order_release);
+}
+
+template <int N>
+int32_t BasicMCTS<N>::selectChild(int32_t index, int32_t first) {
+    const Node& node = arena[index];
+    double logVisits = std::log(std::max<int32_t>(1, node.visits.load(std::memory_order_relaxed)));
+    
+    int32_t best = first;
+    double bestValue = -1.0;
+    for (int32_t child = first; child < first + node.childCount; child++) {
+        int32_t visits = arena[child].visits.load(std::memory_order_relaxed);
+        if (visits == 0) return child;
+        
+        // Playouts still in flight count as losses until they finish (virtual loss)
+        double winRate = arena[child].score.load(std::memory_order_relaxed) / (2.0 * visits);
+        double value = winRate + EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = child;
+        }
+    }
+    return best;
+}
+
+template <int N>
+int BasicMCTS<N>::playout(uint64_t player, uint64_t opponent, Random& random) {
+    int sign = 1;
+    bool passed = false;
+    while (true) {
+        uint64_t moves = Bitboard<N>::legalMoves(player, opponent);
+        if (moves == 0) {
+            if (passed) break;
+            passed = true;
+        } else {
+            passed = false;
+            moves = preferredMoves<N>(moves);
+            for (int skip = random.below(Bitboard<N>::popCount(moves)); skip > 0; skip--) {
+                moves &= moves - 1;
+            }
+            int square = __builtin_ctzll(moves);
+            uint64_t flipped = Bitboard<N>::flips(player, opponent, square);
+            player |= flipped | (1ULL << square);
+            opponent &= ~flipped;
+        }
+        std::swap(player, opponent);
+        sign = -sign;
+    }
+    return sign * (Bitboard<N>::popCount(player) - Bitboard<N>::popCount(opponent));
+}
+
+template <int N>
+void BasicMCTS<N>::iterate(Random& random) {
+    // Every ply (and pass) of the game at most
+    int32_t path[2 * N * N + 2];
+    int length = 0;
+    
+    uint64_t player = rootPlayer;
+    uint64_t opponent = rootOpponent;
+    int32_t index = 0;
+    arena[index].visits.fetch_add(1, std::memory_order_relaxed);
+    path[length++] = index;
+    
+    // Selection: descend while the node has children, expanding a leaf once it has been visited enough
+    while (true) {
+        int32_t first = arena[index].firstChild.load(std::memory_order_acquire);
+        if (first < 0) break;
+        
+        int32_t child = selectChild(index, first);
+        int32_t visitsBefore = arena[child].visits.fetch_add(1, std::memory_order_relaxed);
+        int move = arena[child].move;
+        if (move >= 0) {
+            uint64_t flipped = Bitboard<N>::flips(player, opponent, move);
+            player |= flipped | (1ULL << move);
+            opponent &= ~flipped;
+        }
+        std::swap(player, opponent);
+        index = child;
+        path[length++] = index;
+        
+        if (visitsBefore + 1 >= EXPAND_VISITS) {
+            int32_t expected = LEAF;
+            if (arena[index].firstChild.compare_exchange_strong(expected, EXPANDING, std::memory_order_acq_rel)) {
+                expand(index, player, opponent);
+            }
+        }
+    }
+    
+    // Result for the side to move at the end of the path: 2 win, 1 draw, 0 loss
+    int margin = playout(player, opponent, random);
+    int result = (margin > 0) ? 2 : (margin == 0) ? 1 : 0;
+    
+    // Each node scores for the side that moved into it, alternating up the path
+    result = 2 - result;
+    for (int i = length - 1; i >= 0; i--) {
+        arena[path[i]].score.fetch_add(result, std::memory_order_relaxed);
+        result = 2 - result;
+    }
+}
+
+template <int N>
+void BasicMCTS<N>::run(int thread, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>* stop) {
+    if (thread > 0) TRACE_THREAD_NAME("mcts worker");
+    TRACE_SCOPE_ARG("MCTS::run", "thread", thread);
+    Random random{seed ^ (0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(thread + 1))};
+    if (random.state == 0) random.state = 1;
+    
+    uint64_t count = 0;
+    while (!finished.load(std::memory_order_relaxed)) {
+        iterate(random);
+        if (++count % CLOCK_CHECK_INTERVAL == 0 &&
+            (std::chrono::steady_clock::now() >= deadline ||
+             (stop != nullptr && stop->load(std::memory_order_relaxed)))) {
+            finished.store(true, std::memory_order_relaxed);
+        }
+    }
+    playouts.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <int N>
+int BasicMCTS<N>::search(const int* board, int player, std::chrono::steady_clock::time_point deadline, int threads,
+                         const std::atomic<bool>* stop) {
+    TRACE_SCOPE_ARG("MCTS::search", "threads", threads);
+    Bitboard<N>::fromBoard(board, player, &rootPlayer, &rootOpponent);
+    nodesUsed.store(0);
+    playouts.store(0);
+    finished.store(false);
+    
+    if (Bitboard<N>::legalMoves(rootPlayer, rootOpponent) == 0) return -1;
+    
+    // The root is expanded up front so every thread starts by choosing among the moves
+    int32_t root = allocate(1);
+    Node& node = arena[root];
+    node.visits.store(0, std::memory_order_relaxed);
+    node.score.store(0, std::memory_order_relaxed);
+    node.firstChild.store(LEAF, std::memory_order_relaxed);
+    node.childCount = 0;
+    node.move = -1;
+    expand(root, rootPlayer, rootOpponent);
+    
+    std::vector<std::thread> workers;
+    for (int thread = 1; thread < threads; thread++) {
+        workers.emplace_back(&BasicMCTS::run, this, thread, deadline, stop);
+    }
+    run(0, deadline, stop);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    // The most visited move is the most reliable one
+    int32_t first = node.firstChild.load(std::memory_order_acquire);
+    int bestMove = -1;
+    int32_t bestVisits = -1;
+    for (int32_t child = first; child < first + node.childCount; child++) {
+        int32_t visits = arena[child].visits.load(std::memory_order_relaxed);
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            bestMove = arena[child].move;
+        }
+    }
+    return bestMove;
+}
+
+template <int N>
+uint64_t BasicMCTS<N>::getPlayoutCount() const {
+    return playouts.load(std::memory_order_relaxed);
+}
+
+template <int N>
+int BasicMCTS<N>::getNodeCount() const {
+    return std::min(nodesUsed.load(std::memory_order_relaxed), capacity);
+}
+
+// Supported board sizes (10x10 does not fit a 64-bit bitboard)
+template class BasicMCTS<6>;
+template class BasicMCTS<8>;
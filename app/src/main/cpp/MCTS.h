@@ -0,0 +1,95 @@
+#ifndef REVERSI_MCTS_H
+#define REVERSI_MCTS_H
+
+#include "Bitboard.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Monte-Carlo Tree Search with tree parallelism for boards of up to 64 squares.
+// Nodes come from a preallocated arena, all threads share one tree through atomic
+// counters (no locks), and a virtual loss steers concurrent threads to different lines.
+// Each search starts over in the same arena.
+// The supported sizes (6, 8) are instantiated in MCTS.cpp.
+template <int N>
+class BasicMCTS {
+private:
+    struct Node {
+        std::atomic<int32_t> visits;        // playouts started through this node
+        std::atomic<int32_t> score;         // finished results for the side that moved here: 2 win, 1 draw
+        std::atomic<int32_t> firstChild;    // arena index of the first child, or a negative state
+        int16_t childCount;
+        int8_t move;                        // square played to reach this node, -1 for a pass
+    };
+    
+    // Small fast generator for playouts (one per thread)
+    struct Random {
+        uint64_t state;
+        
+        uint64_t next() {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+        
+        int below(int count) {
+            return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(count)) >> 32);
+        }
+    };
+    
+    std::unique_ptr<Node[]> arena;
+    int capacity;
+    std::atomic<int32_t> nodesUsed;
+    
+    // Search position (side to move's discs and the opponent's)
+    uint64_t rootPlayer;
+    uint64_t rootOpponent;
+    
+    std::atomic<bool> finished;
+    std::atomic<uint64_t> playouts;
+    uint64_t seed;
+    
+    // Claim a node from the arena (-1 if it is full)
+    int32_t allocate(int count);
+    
+    // Create the children of `index` for the side owning `player`; leaves it a leaf if the arena is full
+    void expand(int32_t index, uint64_t player, uint64_t opponent);
+    
+    // Child of `index` (children from `first`) with the best UCT value; unvisited children
+    // come first, in prior order
+    int32_t selectChild(int32_t index, int32_t first);
+    
+    // One selection, expansion, playout and backpropagation step
+    void iterate(Random& random);
+    
+    // Random game to the end; disc margin from `player`'s point of view
+    int playout(uint64_t player, uint64_t opponent, Random& random);
+    
+    // Worker loop until the deadline or `stop`
+    void run(int thread, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>* stop);
+
+public:
+    // Arena size: 16-byte nodes, 8 MB
+    static constexpr int DEFAULT_CAPACITY = 1 << 19;
+    
+    explicit BasicMCTS(int nodeCapacity = DEFAULT_CAPACITY);
+    
+    // Seed the playout generators (for reproducible single-threaded searches)
+    void setSeed(uint64_t value);
+    
+    // Search `board` (N * N squares, 0=empty, 1=black, 2=white) for `player` on `threads`
+    // threads (the caller included) until `deadline` or until `stop` (if given) becomes true.
+    // Returns the most visited move (row * N + col), -1 if `player` has no move.
+    int search(const int* board, int player, std::chrono::steady_clock::time_point deadline, int threads,
+               const std::atomic<bool>* stop);
+    
+    // Playouts of the last search
+    uint64_t getPlayoutCount() const;
+    
+    // Arena nodes used by the last search
+    int getNodeCount() const;
+};
+
+#endif // REVERSI_MCTS_H
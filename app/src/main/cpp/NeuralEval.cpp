@@ -0,0 +1,346 @@
+#include "NeuralEval.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REVERSI_NN_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define REVERSI_NN_NEON 1
+#endif
+
+namespace {
+
+// Weights file header (little-endian, followed by NNWeights)
+struct NNFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t inputs;
+    uint32_t hidden1;
+    uint32_t hidden2;
+    uint32_t evalScale;
+};
+
+constexpr char NN_MAGIC[4] = {'R', 'V', 'N', 'N'};
+constexpr uint32_t NN_FORMAT_VERSION = 1;
+constexpr size_t NN_FILE_SIZE = sizeof(NNFileHeader) + sizeof(NNWeights);
+
+static_assert(sizeof(NNFileHeader) % 8 == 0, "weights must stay aligned after the header");
+
+// Kernel choice for one call
+enum class Kernel {
+    SCALAR,
+    AVX2,
+    NEON
+};
+
+// ---- Scalar reference kernels ----
+
+void addColumnScalar(int16_t* accumulator, const int16_t* column) {
+    for (int i = 0; i < NN_HIDDEN1; i++) {
+        accumulator[i] = static_cast<int16_t>(accumulator[i] + column[i]);
+    }
+}
+
+void subColumnScalar(int16_t* accumulator, const int16_t* column) {
+    for (int i = 0; i < NN_HIDDEN1; i++) {
+        accumulator[i] = static_cast<int16_t>(accumulator[i] - column[i]);
+    }
+}
+
+// out[j] = bias[j] + sum over i of in[i] * weights[j][i]
+void hiddenLayerScalar(const uint8_t* in, const NNWeights& network, int32_t* out) {
+    for (int j = 0; j < NN_HIDDEN2; j++) {
+        int32_t sum = network.hiddenBias[j];
+        for (int i = 0; i < NN_HIDDEN1; i++) {
+            sum += in[i] * network.hiddenWeights[j][i];
+        }
+        out[j] = sum;
+    }
+}
+
+// ---- AVX2 kernels (x86, selected at run time) ----
+
+#ifdef REVERSI_NN_X86
+__attribute__((target("avx2")))
+void addColumnAvx2(int16_t* accumulator, const int16_t* column) {
+    for (int i = 0; i < NN_HIDDEN1; i += 16) {
+        __m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+        __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(accumulator + i), _mm256_add_epi16(sum, weights));
+    }
+}
+
+__attribute__((target("avx2")))
+void subColumnAvx2(int16_t* accumulator, const int16_t* column) {
+    for (int i = 0; i < NN_HIDDEN1; i += 16) {
+        __m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+        __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(accumulator + i), _mm256_sub_epi16(sum, weights));
+    }
+}
+
+__attribute__((target("avx2")))
+void hiddenLayerAvx2(const uint8_t* in, const NNWeights& network, int32_t* out) {
+    static_assert(NN_HIDDEN1 == 64, "kernel reads the inputs as two 32-byte vectors");
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i in0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i in1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 32));
+    
+    for (int j = 0; j < NN_HIDDEN2; j++) {
+        const int8_t* row = network.hiddenWeights[j];
+        __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+        __m256i w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 32));
+        
+        // Adjacent u8 * i8 products summed to int16 cannot saturate (activations are at most 127),
+        // then widened pairwise to int32
+        __m256i p0 = _mm256_madd_epi16(_mm256_maddubs_epi16(in0, w0), ones);
+        __m256i p1 = _mm256_madd_epi16(_mm256_maddubs_epi16(in1, w1), ones);
+        __m256i sum = _mm256_add_epi32(p0, p1);
+        
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[j] = network.hiddenBias[j] + _mm_cvtsi128_si32(half);
+    }
+}
+#endif
+
+// ---- NEON kernels (ARM) ----
+
+#ifdef REVERSI_NN_NEON
+void addColumnNeon(int16_t* accumulator, const int16_t* column) {
+    for (int i = 0; i < NN_HIDDEN1; i += 8) {
+        vst1q_s16(accumulator + i, vaddq_s16(vld1q_s16(accumulator + i), vld1q_s16(column + i)));
+    }
+}
+
+void subColumnNeon(int16_t* accumulator, const int16_t* column) {
+    for (int i = 0; i < NN_HIDDEN1; i += 8) {
+        vst1q_s16(accumulator + i, vsubq_s16(vld1q_s16(accumulator + i), vld1q_s16(column + i)));
+    }
+}
+
+void hiddenLayerNeon(const uint8_t* in, const NNWeights& network, int32_t* out) {
+    // Activations are at most 127, so they can be read as int8
+    const int8_t* input = reinterpret_cast<const int8_t*>(in);
+    for (int j = 0; j < NN_HIDDEN2; j++) {
+        const int8_t* row = network.hiddenWeights[j];
+        int32x4_t sum = vdupq_n_s32(0);
+        for (int i = 0; i < NN_HIDDEN1; i += 16) {
+            int8x16_t a = vld1q_s8(input + i);
+            int8x16_t b = vld1q_s8(row + i);
+            sum = vpadalq_s16(sum, vmull_s8(vget_low_s8(a), vget_low_s8(b)));
+            sum = vpadalq_s16(sum, vmull_s8(vget_high_s8(a), vget_high_s8(b)));
+        }
+        int32x2_t pair = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+        pair = vpadd_s32(pair, pair);
+        out[j] = network.hiddenBias[j] + vget_lane_s32(pair, 0);
+    }
+}
+#endif
+
+// ---- Dispatch ----
+
+// Fastest kernel available (AVX2 only if the CPU reports it)
+inline Kernel vectorKernel(bool avx2) {
+#if defined(REVERSI_NN_NEON)
+    (void)avx2;
+    return Kernel::NEON;
+#else
+    return avx2 ? Kernel::AVX2 : Kernel::SCALAR;
+#endif
+}
+
+inline void addColumn(Kernel kernel, int16_t* accumulator, const int16_t* column) {
+#if defined(REVERSI_NN_X86)
+    if (kernel == Kernel::AVX2) return addColumnAvx2(accumulator, column);
+#elif defined(REVERSI_NN_NEON)
+    if (kernel == Kernel::NEON) return addColumnNeon(accumulator, column);
+#endif
+    (void)kernel;
+    addColumnScalar(accumulator, column);
+}
+
+inline void subColumn(Kernel kernel, int16_t* accumulator, const int16_t* column) {
+#if defined(REVERSI_NN_X86)
+    if (kernel == Kernel::AVX2) return subColumnAvx2(accumulator, column);
+#elif defined(REVERSI_NN_NEON)
+    if (kernel == Kernel::NEON) return subColumnNeon(accumulator, column);
+#endif
+    (void)kernel;
+    subColumnScalar(accumulator, column);
+}
+
+inline void hiddenLayer(Kernel kernel, const uint8_t* in, const NNWeights& network, int32_t* out) {
+#if defined(REVERSI_NN_X86)
+    if (kernel == Kernel::AVX2) return hiddenLayerAvx2(in, network, out);
+#elif defined(REVERSI_NN_NEON)
+    if (kernel == Kernel::NEON) return hiddenLayerNeon(in, network, out);
+#endif
+    (void)kernel;
+    hiddenLayerScalar(in, network, out);
+}
+
+inline int clampActivation(int32_t value) {
+    return std::max(0, std::min(NN_ACTIVATION_ONE, static_cast<int>(value)));
+}
+
+void refreshWith(Kernel kernel, const NNWeights& network, NNAccumulator& accumulator,
+                 uint64_t black, uint64_t white) {
+    std::memcpy(accumulator.values, network.inputBias, sizeof(accumulator.values));
+    for (uint64_t rest = black; rest != 0; rest &= rest - 1) {
+        int feature = NeuralEvaluator::featureIndex(BLACK, __builtin_ctzll(rest));
+        addColumn(kernel, accumulator.values, network.inputWeights[feature]);
+    }
+    for (uint64_t rest = white; rest != 0; rest &= rest - 1) {
+        int feature = NeuralEvaluator::featureIndex(WHITE, __builtin_ctzll(rest));
+        addColumn(kernel, accumulator.values, network.inputWeights[feature]);
+    }
+}
+
+int evaluateWith(Kernel kernel, const NNWeights& network, const NNAccumulator& accumulator) {
+    alignas(32) uint8_t hidden1[NN_HIDDEN1];
+    for (int i = 0; i < NN_HIDDEN1; i++) {
+        hidden1[i] = static_cast<uint8_t>(clampActivation(accumulator.values[i]));
+    }
+    
+    int32_t sums[NN_HIDDEN2];
+    hiddenLayer(kernel, hidden1, network, sums);
+    
+    // The output layer is only 32 products
+    int32_t output = network.outputBias;
+    for (int j = 0; j < NN_HIDDEN2; j++) {
+        output += clampActivation(sums[j] >> NN_WEIGHT_SHIFT) * network.outputWeights[j];
+    }
+    return output * NN_EVAL_SCALE / (NN_ACTIVATION_ONE * NN_WEIGHT_ONE);
+}
+
+} // namespace
+
+NeuralEvaluator::NeuralEvaluator()
+    : mapping(nullptr), mappingSize(0), weights(nullptr), fingerprint(0), useAvx2(false) {
+#ifdef REVERSI_NN_X86
+    useAvx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+NeuralEvaluator::~NeuralEvaluator() {
+    unload();
+}
+
+bool NeuralEvaluator::load(const char* path) {
+    unload();
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != NN_FILE_SIZE) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, NN_FILE_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    
+    NNFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, NN_MAGIC, sizeof(NN_MAGIC)) != 0 || header.version != NN_FORMAT_VERSION ||
+        header.inputs != NN_INPUTS || header.hidden1 != NN_HIDDEN1 || header.hidden2 != NN_HIDDEN2 ||
+        header.evalScale != NN_EVAL_SCALE) {
+        munmap(data, NN_FILE_SIZE);
+        return false;
+    }
+    
+    mapping = data;
+    mappingSize = NN_FILE_SIZE;
+    weights = reinterpret_cast<const NNWeights*>(static_cast<const char*>(data) + sizeof(NNFileHeader));
+    
+    // FNV-1a over the weights
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(weights);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(NNWeights); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    fingerprint = hash | 1;
+    return true;
+}
+
+void NeuralEvaluator::unload() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    weights = nullptr;
+    fingerprint = 0;
+}
+
+bool NeuralEvaluator::isLoaded() const {
+    return weights != nullptr;
+}
+
+uint64_t NeuralEvaluator::getFingerprint() const {
+    return fingerprint;
+}
+
+bool NeuralEvaluator::save(const char* path, const NNWeights& network) {
+    NNFileHeader header;
+    std::memcpy(header.magic, NN_MAGIC, sizeof(NN_MAGIC));
+    header.version = NN_FORMAT_VERSION;
+    header.inputs = NN_INPUTS;
+    header.hidden1 = NN_HIDDEN1;
+    header.hidden2 = NN_HIDDEN2;
+    header.evalScale = NN_EVAL_SCALE;
+    
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(&network, sizeof(network), 1, file) == 1;
+    return std::fclose(file) == 0 && ok;
+}
+
+void NeuralEvaluator::refresh(NNAccumulator& accumulator, uint64_t black, uint64_t white) const {
+    Kernel kernel = vectorKernel(useAvx2);
+    refreshWith(kernel, *weights, accumulator, black, white);
+}
+
+void NeuralEvaluator::applyMove(NNAccumulator& accumulator, int player, int square, uint64_t flipped) const {
+    Kernel kernel = vectorKernel(useAvx2);
+    const auto& columns = weights->inputWeights;
+    addColumn(kernel, accumulator.values, columns[featureIndex(player, square)]);
+    for (uint64_t rest = flipped; rest != 0; rest &= rest - 1) {
+        int flippedSquare = __builtin_ctzll(rest);
+        subColumn(kernel, accumulator.values, columns[featureIndex(opponentOf(player), flippedSquare)]);
+        addColumn(kernel, accumulator.values, columns[featureIndex(player, flippedSquare)]);
+    }
+}
+
+int NeuralEvaluator::evaluate(const NNAccumulator& accumulator) const {
+    return evaluateWith(vectorKernel(useAvx2), *weights, accumulator);
+}
+
+void NeuralEvaluator::refreshReference(NNAccumulator& accumulator, uint64_t black, uint64_t white) const {
+    refreshWith(Kernel::SCALAR, *weights, accumulator, black, white);
+}
+
+int NeuralEvaluator::evaluateReference(const NNAccumulator& accumulator) const {
+    return evaluateWith(Kernel::SCALAR, *weights, accumulator);
+}
+
+const char* NeuralEvaluator::kernelName() const {
+#if defined(REVERSI_NN_X86)
+    return useAvx2 ? "avx2" : "scalar";
+#elif defined(REVERSI_NN_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,95 @@
+#ifndef REVERSI_NEURALEVAL_H
+#define REVERSI_NEURALEVAL_H
+
+#include "GameEngine.h"
+#include <cstddef>
+#include <cstdint>
+
+// Board size the network is defined for
+constexpr int NN_BOARD_SIZE = 8;
+
+// Layer sizes: one input per square and colour, two clipped-ReLU hidden layers, one output
+constexpr int NN_INPUTS = 2 * NN_BOARD_SIZE * NN_BOARD_SIZE;
+constexpr int NN_HIDDEN1 = 64;
+constexpr int NN_HIDDEN2 = 32;
+
+// Fixed-point scales: activations run 0..NN_ACTIVATION_ONE (1.0), hidden and output weights
+// are int8 with NN_WEIGHT_ONE as 1.0, and one network output unit is NN_EVAL_SCALE evaluation points
+constexpr int NN_ACTIVATION_ONE = 127;
+constexpr int NN_WEIGHT_ONE = 64;
+constexpr int NN_WEIGHT_SHIFT = 6;
+constexpr int NN_EVAL_SCALE = 100;
+
+static_assert((1 << NN_WEIGHT_SHIFT) == NN_WEIGHT_ONE, "weight scale must be a power of two");
+
+// Quantized weights, in file order after the header
+struct NNWeights {
+    int16_t inputWeights[NN_INPUTS][NN_HIDDEN1];    // scale NN_ACTIVATION_ONE
+    int16_t inputBias[NN_HIDDEN1];
+    int8_t hiddenWeights[NN_HIDDEN2][NN_HIDDEN1];   // scale NN_WEIGHT_ONE
+    int32_t hiddenBias[NN_HIDDEN2];                 // scale NN_ACTIVATION_ONE * NN_WEIGHT_ONE
+    int8_t outputWeights[NN_HIDDEN2];
+    int32_t outputBias;
+};
+
+// First-layer sums of one position. Placing or flipping a disc adds or subtracts one weight
+// column, so the search can update it per move instead of rebuilding it at every leaf.
+struct NNAccumulator {
+    alignas(32) int16_t values[NN_HIDDEN1];
+};
+
+// Evaluation network read from a memory-mapped weights file (written by tools/nn_train).
+// Inference uses AVX2 on x86 (chosen at run time) or NEON on ARM; the scalar reference
+// computes bit-identical results.
+class NeuralEvaluator {
+private:
+    void* mapping;
+    size_t mappingSize;
+    const NNWeights* weights;
+    uint64_t fingerprint;
+    bool useAvx2;
+
+public:
+    NeuralEvaluator();
+    ~NeuralEvaluator();
+    
+    NeuralEvaluator(const NeuralEvaluator&) = delete;
+    NeuralEvaluator& operator=(const NeuralEvaluator&) = delete;
+    
+    // Map a weights file - returns false (nothing loaded) if it is missing or invalid
+    bool load(const char* path);
+    
+    // Release the mapping
+    void unload();
+    
+    bool isLoaded() const;
+    
+    // Hash of the loaded weights, to tell networks apart (never 0; 0 when nothing is loaded)
+    uint64_t getFingerprint() const;
+    
+    // Write a weights file
+    static bool save(const char* path, const NNWeights& network);
+    
+    // Input index of a disc of `colour` (BLACK or WHITE) on `square` (row * 8 + col)
+    static int featureIndex(int colour, int square) {
+        return (colour == WHITE ? NN_BOARD_SIZE * NN_BOARD_SIZE : 0) + square;
+    }
+    
+    // Accumulator of a position from scratch
+    void refresh(NNAccumulator& accumulator, uint64_t black, uint64_t white) const;
+    
+    // `player` places a disc on `square` and flips `flipped`
+    void applyMove(NNAccumulator& accumulator, int player, int square, uint64_t flipped) const;
+    
+    // Score from White's point of view in evaluation points
+    int evaluate(const NNAccumulator& accumulator) const;
+    
+    // Scalar reference of refresh and evaluate (for checking the vector kernels)
+    void refreshReference(NNAccumulator& accumulator, uint64_t black, uint64_t white) const;
+    int evaluateReference(const NNAccumulator& accumulator) const;
+    
+    // Kernel in use: "avx2", "neon" or "scalar"
+    const char* kernelName() const;
+};
+
+#endif // REVERSI_NEURALEVAL_H
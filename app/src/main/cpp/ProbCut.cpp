@@ -0,0 +1,200 @@
+#include "ProbCut.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct DefaultEntry {
+    int stage;
+    int depth;
+    int shallow;
+    double a;
+    double b;
+    double sigma;
+};
+
+// Fitted defaults: stage, depth, shallow, a, b, sigma
+// Generated by: mpc_fit --random 1200 --max-depth 8 --seed 1 --cpp
+const DefaultEntry DEFAULT_PARAMS[] = {
+    {0,  3,  1, 0.991, 0.4, 2.1},
+    {0,  4,  2, 0.995, 0.1, 2.0},
+    {0,  5,  1, 0.994, 0.6, 2.5},
+    {0,  5,  3, 1.003, 0.2, 1.5},
+    {0,  6,  2, 0.986, 0.0, 2.6},
+    {0,  6,  4, 0.991, -0.1, 1.8},
+    {0,  7,  3, 0.998, 0.4, 2.4},
+    {0,  7,  5, 0.997, 0.1, 1.5},
+    {0,  8,  4, 1.000, -0.2, 2.3},
+    {0,  8,  6, 1.009, -0.1, 1.2},
+    {1,  3,  1, 1.012, 0.2, 7.8},
+    {1,  4,  2, 1.004, 0.4, 5.7},
+    {1,  5,  1, 1.023, 0.2, 8.7},
+    {1,  5,  3, 1.009, 0.0, 4.8},
+    {1,  6,  2, 1.016, 0.5, 7.3},
+    {1,  6,  4, 1.010, 0.1, 5.3},
+    {1,  7,  3, 1.013, 0.3, 7.2},
+    {1,  7,  5, 1.006, 0.2, 4.8},
+    {1,  8,  4, 1.017, 0.6, 7.3},
+    {1,  8,  6, 1.009, 0.4, 3.4},
+    {2,  3,  1, 0.996, -0.5, 15.0},
+    {2,  4,  2, 1.016, 0.3, 12.2},
+    {2,  5,  1, 1.000, -1.2, 19.8},
+    {2,  5,  3, 1.009, -0.8, 10.2},
+    {2,  6,  2, 1.019, 0.8, 17.2},
+    {2,  6,  4, 1.009, 0.4, 8.8},
+    {2,  7,  3, 1.016, -0.1, 18.4},
+    {2,  7,  5, 1.015, 0.5, 11.5},
+    {2,  8,  4, 1.033, 1.6, 16.3},
+    {2,  8,  6, 1.029, 1.1, 11.0},
+    {3,  3,  1, 0.999, -1.4, 17.5},
+    {3,  4,  2, 0.995, 2.2, 14.5},
+    {3,  5,  1, 1.000, -1.2, 23.4},
+    {3,  5,  3, 1.004, 0.1, 12.7},
+    {3,  6,  2, 1.009, 3.4, 22.2},
+    {3,  6,  4, 1.017, 1.1, 13.6},
+    {3,  7,  3, 1.023, 0.3, 22.2},
+    {3,  7,  5, 1.025, 0.0, 13.0},
+    {3,  8,  4, 1.043, 4.3, 25.7},
+    {3,  8,  6, 1.032, 3.0, 16.8},
+    {4,  3,  1, 1.000, -2.5, 25.7},
+    {4,  4,  2, 1.011, 2.6, 23.3},
+    {4,  5,  1, 1.009, -7.3, 38.9},
+    {4,  5,  3, 1.015, -5.0, 22.9},
+    {4,  6,  2, 1.027, 5.2, 38.1},
+    {4,  6,  4, 1.022, 2.5, 23.8},
+    {4,  7,  3, 1.056, -5.3, 40.9},
+    {4,  7,  5, 1.045, -0.2, 28.2},
+    {4,  8,  4, 1.085, 9.3, 49.2},
+    {4,  8,  6, 1.070, 6.5, 35.6},
+    {5,  3,  1, 0.991, -15.5, 53.3},
+    {5,  4,  2, 1.015, 1.8, 59.2},
+    {5,  5,  1, 1.083, -25.2, 75.9},
+    {5,  5,  3, 1.060, -16.5, 58.5},
+    {5,  6,  2, 1.118, 12.6, 86.8},
+    {5,  6,  4, 1.084, 8.3, 57.2},
+    {5,  7,  3, 1.081, -9.0, 84.1},
+    {5,  7,  5, 1.041, -3.5, 50.1},
+    {5,  8,  4, 1.059, 18.2, 91.0},
+    {5,  8,  6, 0.996, 15.7, 71.1},
+};
+
+ProbCutParams table[PROBCUT_STAGES][PROBCUT_MAX_DEPTH + 1][PROBCUT_TRIES];
+
+// Find the attempt slot whose check depth is `shallow`
+int findAttempt(int depth, int shallow) {
+    for (int attempt = 0; attempt < PROBCUT_TRIES; attempt++) {
+        if (getProbCutShallowDepth(depth, attempt) == shallow) return attempt;
+    }
+    return -1;
+}
+
+bool isValidSlot(int stage, int depth) {
+    return stage >= 0 && stage < PROBCUT_STAGES &&
+           depth >= PROBCUT_MIN_DEPTH && depth <= PROBCUT_MAX_DEPTH;
+}
+
+// Depths beyond the fitted range reuse the deepest fit with the same depth gap
+// (the regression changes slowly with depth once the gap is fixed)
+void extendToMaxDepth(ProbCutParams params[PROBCUT_STAGES][PROBCUT_MAX_DEPTH + 1][PROBCUT_TRIES]) {
+    for (int stage = 0; stage < PROBCUT_STAGES; stage++) {
+        for (int depth = PROBCUT_MIN_DEPTH + 2; depth <= PROBCUT_MAX_DEPTH; depth++) {
+            for (int attempt = 0; attempt < PROBCUT_TRIES; attempt++) {
+                int shallow = getProbCutShallowDepth(depth, attempt);
+                if (shallow == 0 || params[stage][depth][attempt].shallowDepth > 0) continue;
+                
+                int gap = depth - shallow;
+                int prevAttempt = findAttempt(depth - 2, shallow - 2);
+                if (prevAttempt < 0) continue;
+                
+                const ProbCutParams& prev = params[stage][depth - 2][prevAttempt];
+                if (prev.shallowDepth > 0 && depth - 2 - prev.shallowDepth == gap) {
+                    params[stage][depth][attempt] = {shallow, prev.a, prev.b, prev.sigma};
+                }
+            }
+        }
+    }
+}
+
+// Fill the table from DEFAULT_PARAMS before first use
+struct DefaultTableLoader {
+    DefaultTableLoader() {
+        std::memset(table, 0, sizeof(table));
+        for (const auto& entry : DEFAULT_PARAMS) {
+            int attempt = findAttempt(entry.depth, entry.shallow);
+            if (attempt < 0 || !isValidSlot(entry.stage, entry.depth)) continue;
+            table[entry.stage][entry.depth][attempt] = {entry.shallow, entry.a, entry.b, entry.sigma};
+        }
+        extendToMaxDepth(table);
+    }
+};
+
+const DefaultTableLoader defaultTableLoader;
+
+} // namespace
+
+int getProbCutStage(int discCount) {
+    int stage = (discCount - 4) / 10;
+    if (stage < 0) return 0;
+    if (stage >= PROBCUT_STAGES) return PROBCUT_STAGES - 1;
+    return stage;
+}
+
+int getProbCutShallowDepth(int depth, int attempt) {
+    // Check depths keep the parity of the deep search (odd/even effect),
+    // cheapest first: depth - 4, then depth - 2
+    int candidates[PROBCUT_TRIES];
+    int count = 0;
+    if (depth - 4 >= 1) candidates[count++] = depth - 4;
+    if (depth - 2 >= 1) candidates[count++] = depth - 2;
+    
+    if (attempt < 0 || attempt >= count) return 0;
+    return candidates[attempt];
+}
+
+const ProbCutParams* getProbCutParams(int stage, int depth, int attempt) {
+    if (!isValidSlot(stage, depth) || attempt < 0 || attempt >= PROBCUT_TRIES) return nullptr;
+    
+    const ProbCutParams& params = table[stage][depth][attempt];
+    return params.shallowDepth > 0 ? &params : nullptr;
+}
+
+void setProbCutParams(int stage, int depth, int attempt, const ProbCutParams& params) {
+    if (!isValidSlot(stage, depth) || attempt < 0 || attempt >= PROBCUT_TRIES) return;
+    table[stage][depth][attempt] = params;
+}
+
+bool loadProbCutParams(const char* path) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return false;
+    
+    ProbCutParams loaded[PROBCUT_STAGES][PROBCUT_MAX_DEPTH + 1][PROBCUT_TRIES];
+    std::memset(loaded, 0, sizeof(loaded));
+    
+    bool ok = true;
+    char line[256];
+    while (ok && std::fgets(line, sizeof(line), file) != nullptr) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        
+        int stage, depth, shallow;
+        double a, b, sigma;
+        if (std::sscanf(line, "%d %d %d %lf %lf %lf", &stage, &depth, &shallow, &a, &b, &sigma) != 6) {
+            ok = false;
+            break;
+        }
+        
+        // A non-positive slope or sigma would invert or disable the cut test
+        int attempt = findAttempt(depth, shallow);
+        if (!isValidSlot(stage, depth) || attempt < 0 || a <= 0.0 || sigma <= 0.0) {
+            ok = false;
+            break;
+        }
+        loaded[stage][depth][attempt] = {shallow, a, b, sigma};
+    }
+    std::fclose(file);
+    
+    if (ok) {
+        extendToMaxDepth(loaded);
+        std::memcpy(table, loaded, sizeof(table));
+    }
+    return ok;
+}
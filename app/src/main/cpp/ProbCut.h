@@ -0,0 +1,50 @@
+#ifndef REVERSI_PROBCUT_H
+#define REVERSI_PROBCUT_H
+
+// Multi-ProbCut (Buro) selective search parameters.
+//
+// For a node searched to `depth`, a shallow search to `shallowDepth` predicts the
+// deep value as  deep ~= a * shallow + b  with residual standard deviation `sigma`.
+// The table is fitted offline per game stage and depth pair (see tools/mpc_fit.cpp).
+
+// Board size the parameters are fitted for (other sizes search full-width)
+constexpr int PROBCUT_BOARD_SIZE = 8;
+
+// Deepest remaining depth that has cut parameters
+constexpr int PROBCUT_MAX_DEPTH = 14;
+
+// Shallowest remaining depth at which a cut is attempted
+constexpr int PROBCUT_MIN_DEPTH = 3;
+
+// Number of game stages (bucketed by discs on the board)
+constexpr int PROBCUT_STAGES = 6;
+
+// Check searches tried per depth, cheapest first
+constexpr int PROBCUT_TRIES = 2;
+
+// Default cut confidence (multiples of sigma)
+constexpr double PROBCUT_DEFAULT_CONFIDENCE = 1.5;
+
+struct ProbCutParams {
+    int shallowDepth;   // 0 = no cut for this slot
+    double a;
+    double b;
+    double sigma;
+};
+
+// Game stage for a position with the given number of discs
+int getProbCutStage(int discCount);
+
+// Shallow check depth used by the given attempt at `depth` (0 if none)
+int getProbCutShallowDepth(int depth, int attempt);
+
+// Parameters for (stage, depth, attempt), or nullptr if that slot has no cut
+const ProbCutParams* getProbCutParams(int stage, int depth, int attempt);
+
+// Replace one slot of the active table
+void setProbCutParams(int stage, int depth, int attempt, const ProbCutParams& params);
+
+// Load a parameter file written by mpc_fit; returns false (table unchanged) on error
+bool loadProbCutParams(const char* path);
+
+#endif // REVERSI_PROBCUT_H
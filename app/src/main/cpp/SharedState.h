@@ -0,0 +1,28 @@
+#ifndef REVERSI_SHAREDSTATE_H
+#define REVERSI_SHAREDSTATE_H
+
+#include <cstdint>
+
+// Layout of the direct ByteBuffer the native layer publishes game state into
+// (mirrored by GameStateBuffer.kt - keep both in sync). Native byte order.
+//
+// Updates use a seqlock: `sequence` is odd while an update is being written and
+// advances by 2 per published state, so readers retry until they see the same
+// even value before and after copying, and skip work when it has not changed.
+struct SharedGameState {
+    uint32_t sequence;
+    int8_t currentPlayer;
+    int8_t lastMoveRow;     // -1 if no move yet
+    int8_t lastMoveCol;
+    int8_t winner;          // -1 = no winner yet, 0 = draw, 1 = black, 2 = white
+    uint8_t blackScore;
+    uint8_t whiteScore;
+    uint8_t reserved[6];
+    uint64_t blackMoves;    // bit (row * 8 + col) set where Black can move
+    uint64_t whiteMoves;    // bit (row * 8 + col) set where White can move
+    int8_t board[64];       // 0 = empty, 1 = black, 2 = white
+};
+
+static_assert(sizeof(SharedGameState) == 96, "SharedGameState layout is shared with Kotlin");
+
+#endif // REVERSI_SHAREDSTATE_H
@@ -0,0 +1,246 @@
+#include "Snapshot.h"
+#include "GameEngine.h"
+#include "AI.h"
+#include <cerrno>
+#include <unistd.h>
+
+namespace {
+
+// "RVSN"
+constexpr uint32_t SNAPSHOT_MAGIC = 0x4E535652;
+
+// magic + version + flags + payload size + checksum
+constexpr size_t HEADER_SIZE = 4 + 2 + 2 + 4 + 4;
+
+// Typical session size (engine history plus settings), avoids regrowth while writing
+constexpr size_t TYPICAL_SNAPSHOT_SIZE = 4096;
+
+// FNV-1a over the payload, to reject torn or truncated files
+uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void patchU32(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(std::vector<uint8_t>& buffer) : out(buffer) {
+}
+
+void SnapshotWriter::writeU8(uint8_t value) {
+    out.push_back(value);
+}
+
+void SnapshotWriter::writeI8(int8_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void SnapshotWriter::writeU16(uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void SnapshotWriter::writeU32(uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+void SnapshotWriter::writeI32(int32_t value) {
+    writeU32(static_cast<uint32_t>(value));
+}
+
+void SnapshotWriter::writeU64(uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    out.insert(out.end(), bytes, bytes + 8);
+}
+
+void SnapshotWriter::writeBoard(const int* board, int squares) {
+    for (int i = 0; i < squares; i += 4) {
+        uint8_t packed = 0;
+        for (int j = 0; j < 4 && i + j < squares; j++) {
+            packed |= static_cast<uint8_t>((board[i + j] & 3) << (2 * j));
+        }
+        out.push_back(packed);
+    }
+}
+
+void SnapshotWriter::reserve(size_t bytes) {
+    out.reserve(out.size() + bytes);
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* bytes, size_t length) : data(bytes), size(length), pos(0) {
+}
+
+bool SnapshotReader::readU8(uint8_t* value) {
+    if (size - pos < 1) return false;
+    *value = data[pos++];
+    return true;
+}
+
+bool SnapshotReader::readI8(int8_t* value) {
+    uint8_t raw;
+    if (!readU8(&raw)) return false;
+    *value = static_cast<int8_t>(raw);
+    return true;
+}
+
+bool SnapshotReader::readU16(uint16_t* value) {
+    if (size - pos < 2) return false;
+    *value = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+    pos += 2;
+    return true;
+}
+
+bool SnapshotReader::readU32(uint32_t* value) {
+    if (size - pos < 4) return false;
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        result |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+    }
+    pos += 4;
+    *value = result;
+    return true;
+}
+
+bool SnapshotReader::readI32(int32_t* value) {
+    uint32_t raw;
+    if (!readU32(&raw)) return false;
+    *value = static_cast<int32_t>(raw);
+    return true;
+}
+
+bool SnapshotReader::readU64(uint64_t* value) {
+    if (size - pos < 8) return false;
+    uint64_t result = 0;
+    for (int i = 0; i < 8; i++) {
+        result |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+    }
+    pos += 8;
+    *value = result;
+    return true;
+}
+
+bool SnapshotReader::readBoard(int* board, int squares) {
+    size_t bytes = static_cast<size_t>(squares + 3) / 4;
+    if (size - pos < bytes) return false;
+    for (int i = 0; i < squares; i += 4) {
+        uint8_t packed = data[pos++];
+        for (int j = 0; j < 4 && i + j < squares; j++) {
+            int square = (packed >> (2 * j)) & 3;
+            if (square != EMPTY && square != BLACK && square != WHITE) return false;
+            board[i + j] = square;
+        }
+    }
+    return true;
+}
+
+size_t SnapshotReader::remaining() const {
+    return size - pos;
+}
+
+void saveSnapshot(GameEngine& engine, AI* ai, bool includeCaches, std::vector<uint8_t>& out) {
+    uint16_t flags = 0;
+    if (ai != nullptr) {
+        flags |= SNAPSHOT_FLAG_AI;
+        if (includeCaches) flags |= SNAPSHOT_FLAG_CACHES;
+    }
+    
+    out.clear();
+    out.reserve(TYPICAL_SNAPSHOT_SIZE);
+    
+    SnapshotWriter writer(out);
+    writer.writeU32(SNAPSHOT_MAGIC);
+    writer.writeU16(SNAPSHOT_VERSION);
+    writer.writeU16(flags);
+    writer.writeU32(0);     // payload size, patched below
+    writer.writeU32(0);     // checksum, patched below
+    
+    engine.writeSnapshot(writer);
+    if (ai != nullptr) {
+        ai->writeSnapshot(writer, includeCaches);
+    }
+    
+    size_t payloadSize = out.size() - HEADER_SIZE;
+    patchU32(out, 8, static_cast<uint32_t>(payloadSize));
+    patchU32(out, 12, checksum(out.data() + HEADER_SIZE, payloadSize));
+}
+
+bool loadSnapshot(GameEngine& engine, AI* ai, const uint8_t* data, size_t size) {
+    if (data == nullptr || size < HEADER_SIZE) return false;
+    
+    SnapshotReader header(data, HEADER_SIZE);
+    uint32_t magic, payloadSize, expectedChecksum;
+    uint16_t version, flags;
+    header.readU32(&magic);
+    header.readU16(&version);
+    header.readU16(&flags);
+    header.readU32(&payloadSize);
+    header.readU32(&expectedChecksum);
+    
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) return false;
+    if (payloadSize != size - HEADER_SIZE) return false;
+    
+    const uint8_t* payload = data + HEADER_SIZE;
+    if (checksum(payload, payloadSize) != expectedChecksum) return false;
+    
+    // Decode into a scratch engine first so a bad snapshot never leaves a half-restored game
+    SnapshotReader reader(payload, payloadSize);
+    GameEngine restored;
+    if (!restored.readSnapshot(reader)) return false;
+    
+    // Nothing may follow the last section (the AI checks its own, and is skipped without an AI)
+    if ((flags & SNAPSHOT_FLAG_AI) && ai != nullptr) {
+        if (!ai->readSnapshot(reader)) return false;
+    } else if (!(flags & SNAPSHOT_FLAG_AI) && reader.remaining() != 0) {
+        return false;
+    }
+    
+    engine = restored;
+    return true;
+}
+
+bool saveSnapshotToFd(int fd, GameEngine& engine, AI* ai, bool includeCaches) {
+    std::vector<uint8_t> buffer;
+    saveSnapshot(engine, ai, includeCaches, buffer);
+    
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t result = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool loadSnapshotFromFd(int fd, GameEngine& engine, AI* ai) {
+    std::vector<uint8_t> buffer;
+    uint8_t chunk[16384];
+    while (true) {
+        ssize_t result = ::read(fd, chunk, sizeof(chunk));
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (result == 0) break;
+        buffer.insert(buffer.end(), chunk, chunk + result);
+    }
+    return loadSnapshot(engine, ai, buffer.data(), buffer.size());
+}
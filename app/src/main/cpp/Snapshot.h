@@ -0,0 +1,75 @@
+#ifndef REVERSI_SNAPSHOT_H
+#define REVERSI_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+template <int N> class BasicGameEngine;
+template <int N> class BasicAI;
+using GameEngine = BasicGameEngine<8>;
+using AI = BasicAI<8>;
+
+// Snapshot layout version (bump on any format change; older versions are rejected)
+constexpr uint16_t SNAPSHOT_VERSION = 4;
+
+// Header flags
+constexpr uint16_t SNAPSHOT_FLAG_AI = 1 << 0;        // AI settings section present
+constexpr uint16_t SNAPSHOT_FLAG_CACHES = 1 << 1;    // AI section carries the transposition table
+
+// Little-endian binary writer appending to a byte buffer
+class SnapshotWriter {
+private:
+    std::vector<uint8_t>& out;
+
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& buffer);
+    
+    void writeU8(uint8_t value);
+    void writeI8(int8_t value);
+    void writeU16(uint16_t value);
+    void writeU32(uint32_t value);
+    void writeI32(int32_t value);
+    void writeU64(uint64_t value);
+    
+    // Board squares packed at 2 bits each (16 bytes for 8x8)
+    void writeBoard(const int* board, int squares);
+    
+    // Reserve room for `bytes` more bytes
+    void reserve(size_t bytes);
+};
+
+// Bounds-checked reader; every read returns false once the data runs out
+class SnapshotReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+public:
+    SnapshotReader(const uint8_t* bytes, size_t length);
+    
+    bool readU8(uint8_t* value);
+    bool readI8(int8_t* value);
+    bool readU16(uint16_t* value);
+    bool readU32(uint32_t* value);
+    bool readI32(int32_t* value);
+    bool readU64(uint64_t* value);
+    
+    // Unpack a board written by writeBoard (rejects invalid square values)
+    bool readBoard(int* board, int squares);
+    
+    size_t remaining() const;
+};
+
+// Serialize the session (engine state, AI settings and optionally the AI's search caches)
+void saveSnapshot(GameEngine& engine, AI* ai, bool includeCaches, std::vector<uint8_t>& out);
+
+// Restore a session - returns false and leaves everything unchanged if the data is invalid
+bool loadSnapshot(GameEngine& engine, AI* ai, const uint8_t* data, size_t size);
+
+// File descriptor variants (the caller owns and closes the descriptor)
+bool saveSnapshotToFd(int fd, GameEngine& engine, AI* ai, bool includeCaches);
+bool loadSnapshotFromFd(int fd, GameEngine& engine, AI* ai);
+
+#endif // REVERSI_SNAPSHOT_H
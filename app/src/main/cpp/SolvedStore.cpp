@@ -0,0 +1,472 @@
+#include "SolvedStore.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// File header (followed by the records)
+struct StoreFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t boardSize;
+    uint32_t recordSize;
+};
+
+constexpr char STORE_MAGIC[4] = {'R', 'V', 'S', 'S'};
+constexpr uint32_t STORE_FORMAT_VERSION = 1;
+
+// Smallest index (slots); it stays at most half full
+constexpr size_t MIN_INDEX_SLOTS = 1024;
+
+static_assert(sizeof(StoreFileHeader) % 8 == 0, "records must stay aligned after the header");
+
+// The 8 symmetries of the square board as square and bitboard maps
+template <int N>
+struct Symmetries {
+    static constexpr int BYTES = (N * N + 7) / 8;
+    
+    int8_t squareMap[8][N * N];     // square -> transformed square
+    int8_t inverseMap[8][N * N];    // transformed square -> square
+    uint64_t byteMaps[8][BYTES][256];
+    
+    Symmetries() {
+        for (int s = 0; s < 8; s++) {
+            for (int row = 0; row < N; row++) {
+                for (int col = 0; col < N; col++) {
+                    // Bit 2: transpose, bit 1: mirror columns, bit 0: mirror rows
+                    int r = (s & 4) ? col : row;
+                    int c = (s & 4) ? row : col;
+                    if (s & 1) r = N - 1 - r;
+                    if (s & 2) c = N - 1 - c;
+                    squareMap[s][row * N + col] = static_cast<int8_t>(r * N + c);
+                    inverseMap[s][r * N + c] = static_cast<int8_t>(row * N + col);
+                }
+            }
+            for (int byte = 0; byte < BYTES; byte++) {
+                for (int value = 0; value < 256; value++) {
+                    uint64_t bits = 0;
+                    for (int bit = 0; bit < 8; bit++) {
+                        int square = byte * 8 + bit;
+                        if ((value >> bit & 1) && square < N * N) bits |= 1ULL << squareMap[s][square];
+                    }
+                    byteMaps[s][byte][value] = bits;
+                }
+            }
+        }
+    }
+    
+    uint64_t transform(uint64_t discs, int s) const {
+        uint64_t result = 0;
+        for (int byte = 0; byte < BYTES; byte++) {
+            result |= byteMaps[s][byte][(discs >> (byte * 8)) & 0xFF];
+        }
+        return result;
+    }
+    
+    // Smallest (player, opponent) over all symmetries; returns the symmetry used
+    int canonical(uint64_t player, uint64_t opponent, uint64_t* canonicalPlayer, uint64_t* canonicalOpponent) const {
+        int best = 0;
+        *canonicalPlayer = player;
+        *canonicalOpponent = opponent;
+        for (int s = 1; s < 8; s++) {
+            uint64_t p = transform(player, s);
+            if (p > *canonicalPlayer) continue;
+            uint64_t o = transform(opponent, s);
+            if (p < *canonicalPlayer || o < *canonicalOpponent) {
+                best = s;
+                *canonicalPlayer = p;
+                *canonicalOpponent = o;
+            }
+        }
+        return best;
+    }
+};
+
+template <int N>
+const Symmetries<N>& symmetries() {
+    static const Symmetries<N> tables;
+    return tables;
+}
+
+uint64_t positionHash(uint64_t player, uint64_t opponent) {
+    uint64_t hash = player * 0x9E3779B97F4A7C15ULL ^ opponent * 0xC2B2AE3D27D4EB4FULL;
+    return hash ^ (hash >> 29);
+}
+
+uint32_t recordCheck(uint64_t player, uint64_t opponent, int8_t score, int8_t bestMove) {
+    uint64_t fields = static_cast<uint8_t>(score) | static_cast<uint64_t>(static_cast<uint8_t>(bestMove)) << 8;
+    uint64_t hash = positionHash(player, opponent) ^ (fields + 1) * 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 31;
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+int emptiesOf(int squares, uint64_t player, uint64_t opponent) {
+    return squares - __builtin_popcountll(player | opponent);
+}
+
+// The path no longer names the open file (another process compacted the store)
+bool fileReplaced(int file, const char* path) {
+    struct stat opened;
+    struct stat current;
+    return fstat(file, &opened) != 0 || stat(path, &current) != 0 ||
+           opened.st_dev != current.st_dev || opened.st_ino != current.st_ino;
+}
+
+} // namespace
+
+template <int N>
+BasicSolvedStore<N>::BasicSolvedStore()
+    : fd(-1), mapping(nullptr), mappingSize(0), mappedCount(0), liveCount(0), staleCount(0),
+      hitCount(0), missCount(0) {
+}
+
+template <int N>
+BasicSolvedStore<N>::~BasicSolvedStore() {
+    close();
+}
+
+template <int N>
+const typename BasicSolvedStore<N>::Record& BasicSolvedStore<N>::record(size_t number) const {
+    if (number < mappedCount) {
+        const char* records = static_cast<const char*>(mapping) + sizeof(StoreFileHeader);
+        return reinterpret_cast<const Record*>(records)[number];
+    }
+    return appended[number - mappedCount];
+}
+
+template <int N>
+size_t BasicSolvedStore<N>::findSlot(uint64_t player, uint64_t opponent) const {
+    size_t mask = index.size() - 1;
+    size_t slot = positionHash(player, opponent) & mask;
+    while (index[slot] != 0) {
+        const Record& entry = record(index[slot] - 1);
+        if (entry.player == player && entry.opponent == opponent) break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template <int N>
+void BasicSolvedStore<N>::rebuildIndex(size_t expected) {
+    constexpr uint64_t ALL = (N * N == 64) ? ~0ULL : (1ULL << (N * N)) - 1;
+    size_t total = mappedCount + appended.size();
+    size_t slots = MIN_INDEX_SLOTS;
+    while (slots < 2 * (total + expected)) slots *= 2;
+    index.assign(slots, 0);
+    liveCount = 0;
+    staleCount = 0;
+    
+    for (size_t number = 0; number < total; number++) {
+        const Record& entry = record(number);
+        int empties = emptiesOf(N * N, entry.player, entry.opponent);
+        bool valid = entry.check == recordCheck(entry.player, entry.opponent, entry.score, entry.bestMove) &&
+                     (entry.player & entry.opponent) == 0 && ((entry.player | entry.opponent) & ~ALL) == 0 &&
+                     empties >= SOLVED_STORE_MIN_EMPTIES && empties <= SOLVED_STORE_MAX_EMPTIES &&
+                     entry.score >= -N * N && entry.score <= N * N &&
+                     entry.bestMove >= -1 && entry.bestMove < N * N &&
+                     (entry.bestMove < 0 || ((entry.player | entry.opponent) >> entry.bestMove & 1) == 0);
+        if (!valid) {
+            staleCount++;
+            continue;
+        }
+        size_t slot = findSlot(entry.player, entry.opponent);
+        if (index[slot] != 0) {
+            staleCount++;
+            continue;
+        }
+        index[slot] = static_cast<uint32_t>(number + 1);
+        liveCount++;
+    }
+}
+
+template <int N>
+bool BasicSolvedStore<N>::open(const char* path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return openLocked(path);
+}
+
+template <int N>
+bool BasicSolvedStore<N>::openLocked(const char* path) {
+    closeLocked();
+    
+    // Each process holds a shared lock while the file is open; setting the file up or
+    // replacing it takes an exclusive one
+    int file;
+    for (;;) {
+        file = ::open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (file < 0) return false;
+        if (flock(file, LOCK_SH) != 0) {
+            ::close(file);
+            return false;
+        }
+        // Opened just before a compaction renamed the new file into place: open that one
+        if (fileReplaced(file, path)) {
+            ::close(file);
+            continue;
+        }
+        
+        struct stat info;
+        if (fstat(file, &info) != 0) {
+            ::close(file);
+            return false;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        size_t used = (size < sizeof(StoreFileHeader)) ? size : size - (size - sizeof(StoreFileHeader)) % sizeof(Record);
+        if (size == 0 || used != size) {
+            // A new file needs its header. A record cut short by a crash would misalign every
+            // later append; it is cut off if no other process has the file open (otherwise
+            // the records after it count as damaged until the next compaction).
+            if (flock(file, (size == 0) ? LOCK_EX : LOCK_EX | LOCK_NB) == 0 && !fileReplaced(file, path) &&
+                fstat(file, &info) == 0) {
+                size = static_cast<size_t>(info.st_size);
+                if (size == 0) {
+                    StoreFileHeader header;
+                    std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+                    header.version = STORE_FORMAT_VERSION;
+                    header.boardSize = N;
+                    header.recordSize = sizeof(Record);
+                    if (::write(file, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+                        ::close(file);
+                        return false;
+                    }
+                } else if (size > sizeof(StoreFileHeader)) {
+                    used = size - (size - sizeof(StoreFileHeader)) % sizeof(Record);
+                    if (used != size && ftruncate(file, static_cast<off_t>(used)) != 0) {
+                        ::close(file);
+                        return false;
+                    }
+                }
+                // Start over with a shared lock
+                ::close(file);
+                continue;
+            }
+            if (size == 0) {
+                ::close(file);
+                return false;
+            }
+            if (flock(file, LOCK_SH) != 0 || fileReplaced(file, path)) {
+                ::close(file);
+                continue;
+            }
+        }
+        
+        StoreFileHeader header;
+        if (size < sizeof(header) || pread(file, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+            header.version != STORE_FORMAT_VERSION || header.boardSize != N || header.recordSize != sizeof(Record)) {
+            ::close(file);
+            return false;
+        }
+        break;
+    }
+    
+    fd = file;
+    filePath = path;
+    return mapLocked();
+}
+
+template <int N>
+bool BasicSolvedStore<N>::mapLocked() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    mappedCount = 0;
+    appended.clear();
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        closeLocked();
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    size_t count = (size - sizeof(StoreFileHeader)) / sizeof(Record);
+    if (count > 0) {
+        size_t used = sizeof(StoreFileHeader) + count * sizeof(Record);
+        void* data = mmap(nullptr, used, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            closeLocked();
+            return false;
+        }
+        mapping = data;
+        mappingSize = used;
+        mappedCount = count;
+    }
+    
+    rebuildIndex(0);
+    return true;
+}
+
+template <int N>
+void BasicSolvedStore<N>::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closeLocked();
+}
+
+template <int N>
+void BasicSolvedStore<N>::closeLocked() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    fd = -1;
+    mapping = nullptr;
+    mappingSize = 0;
+    mappedCount = 0;
+    appended.clear();
+    index.clear();
+    filePath.clear();
+    liveCount = 0;
+    staleCount = 0;
+    hitCount = 0;
+    missCount = 0;
+}
+
+template <int N>
+bool BasicSolvedStore<N>::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return fd >= 0;
+}
+
+template <int N>
+bool BasicSolvedStore<N>::lookup(uint64_t player, uint64_t opponent, int* score, int* bestMove) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.empty()) return false;
+    
+    uint64_t canonicalPlayer;
+    uint64_t canonicalOpponent;
+    int s = symmetries<N>().canonical(player, opponent, &canonicalPlayer, &canonicalOpponent);
+    uint32_t number = index[findSlot(canonicalPlayer, canonicalOpponent)];
+    if (number == 0) {
+        missCount++;
+        return false;
+    }
+    
+    const Record& entry = record(number - 1);
+    *score = entry.score;
+    *bestMove = (entry.bestMove < 0) ? -1 : symmetries<N>().inverseMap[s][entry.bestMove];
+    hitCount++;
+    return true;
+}
+
+template <int N>
+bool BasicSolvedStore<N>::add(uint64_t player, uint64_t opponent, int score, int bestMove) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) return false;
+    int empties = emptiesOf(N * N, player, opponent);
+    if (empties < SOLVED_STORE_MIN_EMPTIES || empties > SOLVED_STORE_MAX_EMPTIES) return true;
+    
+    Record entry;
+    int s = symmetries<N>().canonical(player, opponent, &entry.player, &entry.opponent);
+    size_t slot = findSlot(entry.player, entry.opponent);
+    if (index[slot] != 0) return true;
+    
+    entry.score = static_cast<int8_t>(score);
+    entry.bestMove = static_cast<int8_t>((bestMove < 0) ? -1 : symmetries<N>().squareMap[s][bestMove]);
+    entry.reserved[0] = 0;
+    entry.reserved[1] = 0;
+    entry.check = recordCheck(entry.player, entry.opponent, entry.score, entry.bestMove);
+    
+    // One write per record: appends from several processes never interleave
+    if (::write(fd, &entry, sizeof(entry)) != static_cast<ssize_t>(sizeof(entry))) return false;
+    
+    appended.push_back(entry);
+    if (2 * (mappedCount + appended.size()) > index.size()) {
+        rebuildIndex(appended.size());
+    } else {
+        index[slot] = static_cast<uint32_t>(mappedCount + appended.size());
+        liveCount++;
+    }
+    return true;
+}
+
+template <int N>
+bool BasicSolvedStore<N>::compact() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0) return false;
+    
+    // Appends by other processes would go to the replaced file, so only compact while no
+    // other process has the store open
+    std::string path = filePath;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        // A failed conversion may have dropped the shared lock
+        if (flock(fd, LOCK_SH) != 0 || fileReplaced(fd, path.c_str())) {
+            openLocked(path.c_str());
+        }
+        return false;
+    }
+    
+    // Pick up records other processes appended since the file was opened
+    if (!mapLocked()) return false;
+    
+    // Write the live records in file order to a new file, then replace the old one
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        flock(fd, LOCK_SH);
+        return false;
+    }
+    
+    StoreFileHeader header;
+    std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    header.version = STORE_FORMAT_VERSION;
+    header.boardSize = N;
+    header.recordSize = sizeof(Record);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    
+    size_t total = mappedCount + appended.size();
+    for (size_t number = 0; number < total && ok; number++) {
+        const Record& entry = record(number);
+        if (index[findSlot(entry.player, entry.opponent)] != number + 1) continue;
+        ok = std::fwrite(&entry, sizeof(entry), 1, file) == 1;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        flock(fd, LOCK_SH);
+        return false;
+    }
+    return openLocked(path.c_str());
+}
+
+template <int N>
+bool BasicSolvedStore<N>::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return staleCount > 0 && 4 * staleCount >= liveCount + staleCount;
+}
+
+template <int N>
+size_t BasicSolvedStore<N>::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return liveCount;
+}
+
+template <int N>
+size_t BasicSolvedStore<N>::getStaleCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return staleCount;
+}
+
+template <int N>
+uint64_t BasicSolvedStore<N>::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+template <int N>
+uint64_t BasicSolvedStore<N>::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
+
+// Bitboard board sizes
+template class BasicSolvedStore<6>;
+template class BasicSolvedStore<8>;
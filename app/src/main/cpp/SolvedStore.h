@@ -0,0 +1,109 @@
+#ifndef REVERSI_SOLVEDSTORE_H
+#define REVERSI_SOLVEDSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Positions worth keeping: with fewer empties a solve is cheaper than the lookup, with more
+// a solve rarely finishes at all
+constexpr int SOLVED_STORE_MIN_EMPTIES = 12;
+constexpr int SOLVED_STORE_MAX_EMPTIES = 24;
+
+// Exactly solved positions kept across games and sessions in an append-only file.
+//
+// Each position is stored once for its 8 rotations and reflections, under the smallest of
+// them (the canonical form). The existing records are memory-mapped on open and indexed by a
+// hash of the canonical form; new results are appended with one write per record, so engine
+// processes may share a file (each holds a shared flock while it is open). The duplicates they
+// create, and records cut short by a crash, are dropped by compact(). All methods are
+// thread-safe.
+// The bitboard sizes (6, 8) are instantiated in SolvedStore.cpp.
+template <int N>
+class BasicSolvedStore {
+public:
+    // File record (native byte order)
+    struct Record {
+        uint64_t player;        // discs of the side to move, canonical form
+        uint64_t opponent;
+        int8_t score;           // final disc margin with perfect play, side to move's point of view
+        int8_t bestMove;        // square in the canonical form, -1 if the side to move must pass
+        uint8_t reserved[2];
+        uint32_t check;         // hash of the fields above, detects damaged records
+    };
+
+private:
+    std::string filePath;
+    int fd;
+    void* mapping;
+    size_t mappingSize;
+    size_t mappedCount;             // records in the mapping
+    std::vector<Record> appended;   // records written since open (numbered after the mapped ones)
+    std::vector<uint32_t> index;    // open addressing: record number + 1, 0 = free slot
+    size_t liveCount;
+    size_t staleCount;              // duplicate or damaged records in the file
+    uint64_t hitCount;
+    uint64_t missCount;
+    mutable std::mutex mutex;
+    
+    const Record& record(size_t number) const;
+    
+    // Slot holding the canonical position, or the free slot where it belongs
+    size_t findSlot(uint64_t player, uint64_t opponent) const;
+    
+    // Index every record (sized for `expected` more)
+    void rebuildIndex(size_t expected);
+    
+    bool openLocked(const char* path);
+    void closeLocked();
+    
+    // Map and index every complete record of the open file (closes the store on failure)
+    bool mapLocked();
+
+public:
+    BasicSolvedStore();
+    ~BasicSolvedStore();
+    
+    BasicSolvedStore(const BasicSolvedStore&) = delete;
+    BasicSolvedStore& operator=(const BasicSolvedStore&) = delete;
+    
+    // Open (or create) a store file - returns false (store closed) if it cannot be opened or
+    // belongs to another board size
+    bool open(const char* path);
+    
+    void close();
+    
+    bool isOpen() const;
+    
+    // Exact score and best move (row * N + col, -1 for a pass) of a position with
+    // `player` to move; false if it is not stored
+    bool lookup(uint64_t player, uint64_t opponent, int* score, int* bestMove);
+    
+    // Record an exact result (positions outside the stored range of empties are ignored).
+    // Returns false if the store is closed or the file could not be written.
+    bool add(uint64_t player, uint64_t opponent, int score, int bestMove);
+    
+    // Rewrite the file without stale records. Returns false, and leaves the file as it is,
+    // while another process has the store open.
+    bool compact();
+    
+    // Stale records make up a quarter of the file or more
+    bool needsCompaction() const;
+    
+    // Positions stored
+    size_t getRecordCount() const;
+    
+    // Duplicate or damaged records in the file
+    size_t getStaleCount() const;
+    
+    // Lookups since open that found / did not find their position
+    uint64_t getHitCount() const;
+    uint64_t getMissCount() const;
+};
+
+// Store for the standard 8x8 game
+using SolvedStore = BasicSolvedStore<8>;
+
+#endif // REVERSI_SOLVEDSTORE_H
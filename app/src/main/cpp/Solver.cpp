@@ -0,0 +1,271 @@
+#include "Solver.h"
+#include "SolvedStore.h"
+#include <algorithm>
+
+namespace {
+
+// Below this many empties the table and move ordering cost more than they save
+constexpr int MIN_TABLE_EMPTIES = 6;
+constexpr int MIN_ORDERING_EMPTIES = 7;
+
+// Larger than any disc margin
+constexpr int SOLVE_INF = 127;
+
+// Nodes between checks of the time limit
+constexpr uint64_t DEADLINE_CHECK_INTERVAL = 4096;
+
+// Plies below the root that still look positions up in the solved store; deeper, the lock and
+// canonicalization cost more than the rare hit saves
+constexpr int STORE_PROBE_PLIES = 4;
+
+// A store hit is kept in the table entry of its node
+static_assert(SOLVED_STORE_MIN_EMPTIES >= MIN_TABLE_EMPTIES, "stored positions must have table entries");
+
+} // namespace
+
+template <int N>
+BasicSolver<N>::BasicSolver(int tableBits)
+    : table(size_t(1) << tableBits), nodeCount(0), bestMove(-1), store(nullptr), storeProbeEmpties(N * N + 1),
+      useDeadline(false), stopSignal(nullptr), aborted(false) {
+    // Declared for every size so BasicAI can hold one; only bitboard sizes can be built
+    static_assert(N * N <= 64, "bitboard solver needs at most 64 squares");
+    clear();
+}
+
+template <int N>
+typename BasicSolver<N>::Entry& BasicSolver<N>::entryFor(uint64_t player, uint64_t opponent) {
+    uint64_t hash = player * 0x9E3779B97F4A7C15ULL ^ opponent * 0xC2B2AE3D27D4EB4FULL;
+    return table[(hash ^ (hash >> 29)) & (table.size() - 1)];
+}
+
+template <int N>
+int BasicSolver<N>::search(uint64_t player, uint64_t opponent, int alpha, int beta, bool passed) {
+    nodeCount++;
+    if (useDeadline && !aborted && (nodeCount % DEADLINE_CHECK_INTERVAL) == 0 &&
+        (std::chrono::steady_clock::now() >= deadline ||
+         (stopSignal != nullptr && stopSignal->load(std::memory_order_relaxed)))) {
+        aborted = true;
+    }
+    if (aborted) return 0;
+    
+    uint64_t moves = Bitboard<N>::legalMoves(player, opponent);
+    if (moves == 0) {
+        if (passed) {
+            return Bitboard<N>::popCount(player) - Bitboard<N>::popCount(opponent);
+        }
+        return -search(opponent, player, -beta, -alpha, true);
+    }
+    
+    int empties = Bitboard<N>::popCount(~(player | opponent) & Bitboard<N>::ALL);
+    
+    Entry* entry = nullptr;
+    int ttMove = -1;
+    if (empties >= MIN_TABLE_EMPTIES) {
+        entry = &entryFor(player, opponent);
+        if (entry->player == player && entry->opponent == opponent) {
+            if (entry->lower >= beta) return entry->lower;
+            if (entry->upper <= alpha) return entry->upper;
+            if (entry->lower == entry->upper) return entry->lower;
+            ttMove = entry->bestMove;
+        }
+    }
+    
+    // Solved in an earlier session (kept in the table from now on)
+    if (empties >= storeProbeEmpties && store != nullptr &&
+        empties >= SOLVED_STORE_MIN_EMPTIES && empties <= SOLVED_STORE_MAX_EMPTIES) {
+        int score;
+        int move;
+        if (store->lookup(player, opponent, &score, &move)) {
+            entry->player = player;
+            entry->opponent = opponent;
+            entry->lower = static_cast<int8_t>(score);
+            entry->upper = static_cast<int8_t>(score);
+            entry->bestMove = static_cast<int8_t>(move);
+            entry->empties = static_cast<int8_t>(empties);
+            return score;
+        }
+    }
+    
+    // Collect moves; away from the end, search the table move first and then
+    // the moves that leave the opponent the fewest replies (fastest-first)
+    int squares[64];
+    int order[64];
+    int count = 0;
+    for (uint64_t rest = moves; rest != 0; rest &= rest - 1) {
+        int square = __builtin_ctzll(rest);
+        int key = 0;
+        if (empties >= MIN_ORDERING_EMPTIES) {
+            if (square == ttMove) {
+                key = -1;
+            } else {
+                uint64_t flipped = Bitboard<N>::flips(player, opponent, square);
+                uint64_t nextOpponent = opponent & ~flipped;
+                uint64_t nextPlayer = player | flipped | (1ULL << square);
+                uint64_t replies = Bitboard<N>::legalMoves(nextOpponent, nextPlayer);
+                key = Bitboard<N>::popCount(replies) + Bitboard<N>::popCount(replies & Bitboard<N>::CORNERS);
+            }
+        }
+        
+        int i = count++;
+        while (i > 0 && order[i - 1] > key) {
+            squares[i] = squares[i - 1];
+            order[i] = order[i - 1];
+            i--;
+        }
+        squares[i] = square;
+        order[i] = key;
+    }
+    
+    int alphaOrig = alpha;
+    int best = -SOLVE_INF;
+    int bestSquare = -1;
+    for (int i = 0; i < count; i++) {
+        int square = squares[i];
+        uint64_t flipped = Bitboard<N>::flips(player, opponent, square);
+        uint64_t nextPlayer = player | flipped | (1ULL << square);
+        uint64_t nextOpponent = opponent & ~flipped;
+        
+        int value;
+        if (i == 0) {
+            value = -search(nextOpponent, nextPlayer, -beta, -alpha, false);
+        } else {
+            // Null window to prove the move is no better; re-search only if it is
+            value = -search(nextOpponent, nextPlayer, -alpha - 1, -alpha, false);
+            if (value > alpha && value < beta) {
+                value = -search(nextOpponent, nextPlayer, -beta, -value, false);
+            }
+        }
+        
+        if (value > best) {
+            best = value;
+            bestSquare = square;
+        }
+        alpha = std::max(alpha, value);
+        if (alpha >= beta) break;
+    }
+    
+    // Never cache results of an interrupted search
+    if (aborted) return 0;
+    
+    // Keep the more expensive of two colliding results
+    if (entry != nullptr && (entry->empties <= empties ||
+                             (entry->player == player && entry->opponent == opponent))) {
+        entry->player = player;
+        entry->opponent = opponent;
+        entry->lower = static_cast<int8_t>(best > alphaOrig ? best : -SOLVE_INF);
+        entry->upper = static_cast<int8_t>(best < beta ? best : SOLVE_INF);
+        entry->bestMove = static_cast<int8_t>(bestSquare);
+        entry->empties = static_cast<int8_t>(empties);
+    }
+    
+    return best;
+}
+
+template <int N>
+int BasicSolver<N>::solve(const int* board, int player) {
+    uint64_t own;
+    uint64_t other;
+    Bitboard<N>::fromBoard(board, player, &own, &other);
+    return solve(own, other);
+}
+
+template <int N>
+int BasicSolver<N>::solve(uint64_t own, uint64_t other) {
+    aborted = false;
+    bestMove = -1;
+    
+    int empties = Bitboard<N>::popCount(~(own | other) & Bitboard<N>::ALL);
+    storeProbeEmpties = empties - STORE_PROBE_PLIES;
+    bool stored = store != nullptr && empties >= SOLVED_STORE_MIN_EMPTIES && empties <= SOLVED_STORE_MAX_EMPTIES;
+    int storedScore;
+    if (stored && store->lookup(own, other, &storedScore, &bestMove)) return storedScore;
+    
+    // Null-window probes bisect the score range, each one reusing the table (MTD-style);
+    // far cheaper than one full-window search. The first probe decides win/loss.
+    int lower = -N * N;
+    int upper = N * N;
+    int guess = 0;
+    while (lower < upper) {
+        int value = search(own, other, guess, guess + 1, false);
+        if (aborted) return 0;
+        if (value > guess) {
+            lower = value;
+        } else {
+            upper = value;
+        }
+        guess = lower + (upper - lower) / 2;
+    }
+    int result = lower;
+    
+    // The root is always stored with its exact value (unless it is a pass or nearly full)
+    const Entry& root = entryFor(own, other);
+    bestMove = (root.player == own && root.opponent == other) ? root.bestMove : -1;
+    if (bestMove < 0) {
+        uint64_t moves = Bitboard<N>::legalMoves(own, other);
+        for (uint64_t rest = moves; rest != 0 && bestMove < 0; rest &= rest - 1) {
+            int square = __builtin_ctzll(rest);
+            uint64_t flipped = Bitboard<N>::flips(own, other, square);
+            if (-search(other & ~flipped, own | flipped | (1ULL << square), -SOLVE_INF, SOLVE_INF, false) == result) {
+                bestMove = square;
+            }
+        }
+        if (aborted) {
+            bestMove = -1;
+            return 0;
+        }
+    }
+    
+    if (stored) store->add(own, other, result, bestMove);
+    return result;
+}
+
+template <int N>
+int BasicSolver<N>::solveWindow(uint64_t player, uint64_t opponent, int alpha, int beta) {
+    aborted = false;
+    storeProbeEmpties = Bitboard<N>::popCount(~(player | opponent) & Bitboard<N>::ALL) - STORE_PROBE_PLIES;
+    return search(player, opponent, alpha, beta, false);
+}
+
+template <int N>
+void BasicSolver<N>::setStore(BasicSolvedStore<N>* solvedStore) {
+    store = solvedStore;
+}
+
+template <int N>
+void BasicSolver<N>::setDeadline(std::chrono::steady_clock::time_point time, const std::atomic<bool>* stop) {
+    deadline = time;
+    stopSignal = stop;
+    useDeadline = true;
+}
+
+template <int N>
+void BasicSolver<N>::clearDeadline() {
+    useDeadline = false;
+    stopSignal = nullptr;
+}
+
+template <int N>
+bool BasicSolver<N>::wasAborted() const {
+    return aborted;
+}
+
+template <int N>
+int BasicSolver<N>::getBestMove() const {
+    return bestMove;
+}
+
+template <int N>
+uint64_t BasicSolver<N>::getNodeCount() const {
+    return nodeCount;
+}
+
+template <int N>
+void BasicSolver<N>::clear() {
+    std::fill(table.begin(), table.end(), Entry{0, 0, -SOLVE_INF, SOLVE_INF, -1, -1});
+    nodeCount = 0;
+    bestMove = -1;
+}
+
+// Supported board sizes (10x10 does not fit a 64-bit bitboard)
+template class BasicSolver<6>;
+template class BasicSolver<8>;
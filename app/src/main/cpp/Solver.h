@@ -0,0 +1,89 @@
+#ifndef REVERSI_SOLVER_H
+#define REVERSI_SOLVER_H
+
+#include "Bitboard.h"
+#include "GameEngine.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+template <int N>
+class BasicSolvedStore;
+
+// Transposition table sizes (log2 of the entry count): the default for host tools (24 MB),
+// and the one the app's AI uses (1.5 MB)
+constexpr int SOLVER_TABLE_BITS = 20;
+constexpr int SOLVER_MOBILE_TABLE_BITS = 16;
+
+// Exact (perfect play) solver on bitboards for boards of up to 64 squares.
+// The supported sizes (6, 8) are instantiated in Solver.cpp.
+template <int N>
+class BasicSolver {
+private:
+    // Bounds on the exact value of a position (side to move's point of view)
+    struct Entry {
+        uint64_t player;
+        uint64_t opponent;
+        int8_t lower;
+        int8_t upper;
+        int8_t bestMove;    // -1 if none
+        int8_t empties;     // -1 for an unused slot
+    };
+    
+    std::vector<Entry> table;
+    uint64_t nodeCount;
+    int bestMove;
+    
+    // Results kept across sessions (owned by the caller, may be null), consulted by nodes
+    // with at least `storeProbeEmpties` empties
+    BasicSolvedStore<N>* store;
+    int storeProbeEmpties;
+    
+    // Time limit and external stop request (owned by the caller, may be null)
+    std::chrono::steady_clock::time_point deadline;
+    bool useDeadline;
+    const std::atomic<bool>* stopSignal;
+    bool aborted;
+    
+    // Negamax over (side to move, opponent) discs; `passed` if the previous side passed
+    int search(uint64_t player, uint64_t opponent, int alpha, int beta, bool passed);
+    
+    Entry& entryFor(uint64_t player, uint64_t opponent);
+
+public:
+    explicit BasicSolver(int tableBits = SOLVER_TABLE_BITS);
+    
+    // Final disc margin with perfect play from `player`'s point of view
+    // (board holds N * N squares, row-major: 0=empty, 1=black, 2=white)
+    int solve(const int* board, int player);
+    
+    // Same on bitboards (discs of the side to move and of its opponent)
+    int solve(uint64_t player, uint64_t opponent);
+    
+    // Fail-soft alpha-beta search: the exact margin if it lies inside (alpha, beta), otherwise
+    // a bound beyond the window. Does not set the best move.
+    int solveWindow(uint64_t player, uint64_t opponent, int alpha, int beta);
+    
+    // Consult `solvedStore` before searching positions in its range of empties near the root,
+    // and add every solved root position to it (null detaches)
+    void setStore(BasicSolvedStore<N>* solvedStore);
+    
+    // Abort searches at `time` or once `stop` (if given) becomes true
+    void setDeadline(std::chrono::steady_clock::time_point time, const std::atomic<bool>* stop);
+    void clearDeadline();
+    
+    // The last solve or solveWindow call ran out of time; its result is meaningless
+    bool wasAborted() const;
+    
+    // Best move in the last solved position (row * N + col, -1 if it has none)
+    int getBestMove() const;
+    
+    // Nodes visited since construction or the last clear
+    uint64_t getNodeCount() const;
+    
+    // Drop all cached results
+    void clear();
+};
+
+#endif // REVERSI_SOLVER_H
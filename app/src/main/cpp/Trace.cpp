@@ -0,0 +1,230 @@
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+
+#ifdef REVERSI_TRACE
+
+namespace {
+
+// One finished scope
+struct TraceEvent {
+    const char* name;
+    const char* argName;
+    int64_t argValue;
+    uint64_t startNs;
+    uint64_t durationNs;
+    int32_t threadId;
+};
+
+// Ring buffer written only by the thread that claimed it
+struct ThreadBuffer {
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+    std::atomic<uint64_t> written{0};       // events ever recorded (the ring holds the newest)
+    std::atomic<uint64_t> firstKept{0};     // events before this index were cleared
+    std::atomic<bool> inUse{true};
+    std::atomic<int32_t> threadId{0};
+    std::atomic<const char*> threadName{nullptr};
+    ThreadBuffer* next = nullptr;
+};
+
+// Buffers are never freed, only handed to a new thread once their owner exits, so the
+// list can be walked without locks
+std::atomic<ThreadBuffer*> bufferList{nullptr};
+std::atomic<int32_t> nextThreadId{1};
+
+ThreadBuffer* claimBuffer() {
+    // Reuse the buffer of a finished thread. Short-lived threads (the Monte-Carlo workers) then
+    // share one timeline track per buffer instead of adding a track per search.
+    for (ThreadBuffer* buffer = bufferList.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        bool free = false;
+        if (!buffer->inUse.load(std::memory_order_relaxed) &&
+            buffer->inUse.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+            buffer->threadName.store(nullptr, std::memory_order_relaxed);
+            return buffer;
+        }
+    }
+    
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->threadId.store(nextThreadId.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+    ThreadBuffer* head = bufferList.load(std::memory_order_relaxed);
+    do {
+        buffer->next = head;
+    } while (!bufferList.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+    return buffer;
+}
+
+// Claims a buffer on the thread's first event and releases it when the thread exits
+class BufferOwner {
+private:
+    ThreadBuffer* buffer = nullptr;
+
+public:
+    ~BufferOwner() {
+        if (buffer != nullptr) buffer->inUse.store(false, std::memory_order_release);
+    }
+    
+    ThreadBuffer* get() {
+        if (buffer == nullptr) buffer = claimBuffer();
+        return buffer;
+    }
+};
+
+thread_local BufferOwner localBuffer;
+
+// Names are string literals from the engine; escape anyway so the JSON always parses
+void writeJsonString(FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') std::fputc('\\', file);
+        if (static_cast<unsigned char>(*c) >= 0x20) std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+#ifdef __ANDROID__
+// ATrace is exported by libandroid from API 23; looked up at run time since the app supports 21
+struct ATraceFunctions {
+    void (*begin)(const char*) = nullptr;
+    void (*end)() = nullptr;
+    
+    ATraceFunctions() {
+        void* library = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (library == nullptr) return;
+        begin = reinterpret_cast<void (*)(const char*)>(dlsym(library, "ATrace_beginSection"));
+        end = reinterpret_cast<void (*)()>(dlsym(library, "ATrace_endSection"));
+        if (begin == nullptr || end == nullptr) {
+            begin = nullptr;
+            end = nullptr;
+        }
+    }
+};
+
+const ATraceFunctions& atrace() {
+    static const ATraceFunctions functions;
+    return functions;
+}
+#endif
+
+} // namespace
+
+void traceRecord(const char* name, const char* argName, int64_t argValue, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer* buffer = localBuffer.get();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index % TRACE_BUFFER_EVENTS];
+    event.name = name;
+    event.argName = argName;
+    event.argValue = argValue;
+    event.startNs = startNs;
+    event.durationNs = endNs - startNs;
+    event.threadId = buffer->threadId.load(std::memory_order_relaxed);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void traceSetThreadName(const char* name) {
+    localBuffer.get()->threadName.store(name, std::memory_order_relaxed);
+}
+
+bool writeTraceJson(const char* path) {
+    struct ThreadLabel {
+        int32_t threadId;
+        const char* name;
+    };
+    std::vector<TraceEvent> events;
+    std::vector<ThreadLabel> labels;
+    
+    for (ThreadBuffer* buffer = bufferList.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        uint64_t end = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = buffer->firstKept.load(std::memory_order_relaxed);
+        if (end - begin > TRACE_BUFFER_EVENTS) begin = end - TRACE_BUFFER_EVENTS;
+        for (uint64_t i = begin; i < end; i++) {
+            events.push_back(buffer->events[i % TRACE_BUFFER_EVENTS]);
+        }
+        const char* name = buffer->threadName.load(std::memory_order_relaxed);
+        if (name != nullptr) labels.push_back({buffer->threadId.load(std::memory_order_relaxed), name});
+    }
+    
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.startNs < b.startNs;
+    });
+    uint64_t origin = events.empty() ? 0 : events.front().startNs;
+    
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) return false;
+    
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    bool first = true;
+    for (const ThreadLabel& label : labels) {
+        std::fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                     first ? "" : ",", label.threadId);
+        writeJsonString(file, label.name);
+        std::fputs("}}", file);
+        first = false;
+    }
+    for (const TraceEvent& event : events) {
+        std::fprintf(file, "%s\n{\"name\":", first ? "" : ",");
+        writeJsonString(file, event.name);
+        // Chrome traces count in microseconds
+        std::fprintf(file, ",\"cat\":\"reversi\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                     event.threadId, (event.startNs - origin) / 1000.0, event.durationNs / 1000.0);
+        if (event.argName != nullptr) {
+            std::fputs(",\"args\":{", file);
+            writeJsonString(file, event.argName);
+            std::fprintf(file, ":%lld}", static_cast<long long>(event.argValue));
+        }
+        std::fputc('}', file);
+        first = false;
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+void traceClear() {
+    for (ThreadBuffer* buffer = bufferList.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+        buffer->firstKept.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void traceBeginSection(const char* name) {
+#ifdef __ANDROID__
+    if (atrace().begin != nullptr) atrace().begin(name);
+#else
+    (void)name;
+#endif
+}
+
+void traceEndSection() {
+#ifdef __ANDROID__
+    if (atrace().end != nullptr) atrace().end();
+#endif
+}
+
+#else // REVERSI_TRACE
+
+// Tracing compiled out: nothing is recorded and nothing can be written
+
+void traceRecord(const char*, const char*, int64_t, uint64_t, uint64_t) {
+}
+
+void traceSetThreadName(const char*) {
+}
+
+bool writeTraceJson(const char*) {
+    return false;
+}
+
+void traceClear() {
+}
+
+void traceBeginSection(const char*) {
+}
+
+void traceEndSection() {
+}
+
+#endif // REVERSI_TRACE
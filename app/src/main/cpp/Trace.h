@@ -0,0 +1,86 @@
+#ifndef REVERSI_TRACE_H
+#define REVERSI_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+
+// Timeline tracing of the engine's hot paths (JNI entry points, AI turns, search iterations,
+// game moves). Scopes compile to nothing unless the build defines REVERSI_TRACE
+// (cmake -DREVERSI_TRACE=ON). When enabled, every finished scope is written to a lock-free
+// ring buffer owned by the recording thread, and writeTraceJson() dumps all buffers in the
+// Chrome trace format (chrome://tracing, ui.perfetto.dev). Android builds also emit ATrace
+// sections, so the same scopes show up in systrace/Perfetto captures.
+
+// Events kept per thread; older ones are overwritten
+constexpr int TRACE_BUFFER_EVENTS = 1 << 14;
+
+// Monotonic clock of the trace in nanoseconds
+inline uint64_t traceNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Record a finished scope on the calling thread's buffer. `name` and `argName` must be string
+// literals (or otherwise outlive the trace); `argName` may be null.
+void traceRecord(const char* name, const char* argName, int64_t argValue, uint64_t startNs, uint64_t endNs);
+
+// Label the calling thread in the trace (string literal)
+void traceSetThreadName(const char* name);
+
+// Write every buffered event as Chrome trace JSON. Returns false if tracing is compiled out or
+// the file cannot be written. Threads still recording while the dump runs may have their
+// newest events torn or missing.
+bool writeTraceJson(const char* path);
+
+// Drop all buffered events
+void traceClear();
+
+// Platform trace sections (ATrace on Android, no-ops elsewhere)
+void traceBeginSection(const char* name);
+void traceEndSection();
+
+// Records the time between construction and destruction
+class TraceScope {
+private:
+    const char* name;
+    const char* argName;
+    int64_t argValue;
+    uint64_t start;
+
+public:
+    explicit TraceScope(const char* scopeName, const char* scopeArgName = nullptr, int64_t scopeArgValue = 0)
+        : name(scopeName), argName(scopeArgName), argValue(scopeArgValue) {
+#ifdef __ANDROID__
+        traceBeginSection(name);
+#endif
+        start = traceNow();
+    }
+    
+    ~TraceScope() {
+        traceRecord(name, argName, argValue, start, traceNow());
+#ifdef __ANDROID__
+        traceEndSection();
+#endif
+    }
+    
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define REVERSI_TRACE_JOIN2(a, b) a##b
+#define REVERSI_TRACE_JOIN(a, b) REVERSI_TRACE_JOIN2(a, b)
+
+#ifdef REVERSI_TRACE
+// Trace the rest of the enclosing block under `name`
+#define TRACE_SCOPE(name) TraceScope REVERSI_TRACE_JOIN(traceScope, __LINE__)(name)
+// Same, with one named integer argument
+#define TRACE_SCOPE_ARG(name, argName, value) \
+    TraceScope REVERSI_TRACE_JOIN(traceScope, __LINE__)(name, argName, static_cast<int64_t>(value))
+#define TRACE_THREAD_NAME(name) traceSetThreadName(name)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_SCOPE_ARG(name, argName, value) do {} while (0)
+#define TRACE_THREAD_NAME(name) do {} while (0)
+#endif
+
+#endif // REVERSI_TRACE_H
@@ -2,6 +2,15 @@
 #include <string>
 #include "GameEngine.h"
 #include "AI.h"
+#include "NeuralEval.h"
+#include "Snapshot.h"
+#include "SharedState.h"
+#include "SolvedStore.h"
+#include "Trace.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 // Global references to Java objects
 static JavaVM* javaVM = nullptr;
@@ -9,6 +18,25 @@ static jobject javaActivity = nullptr;
 static GameEngine* gameEngine = nullptr;
 static AI* ai = nullptr;
 
+// Optional evaluation network (outlives every AI instance that points at it)
+static NeuralEvaluator neuralEvaluator;
+
+// Solved endgame positions kept across sessions (also outlives the AI instances)
+static SolvedStore solvedStore;
+
+// The app plays the standard board; other sizes are host-side variants
+constexpr int BOARD_SQUARES = GameEngine::SIZE * GameEngine::SIZE;
+static_assert(BOARD_SQUARES == sizeof(SharedGameState::board), "shared state holds one byte per square");
+
+// Direct buffer registered by the renderer (see SharedState.h)
+static SharedGameState* sharedState = nullptr;
+static jobject sharedStateBuffer = nullptr;
+static std::mutex sharedStateMutex;
+
+// Serializes changes to the game engine with snapshots of it: the AI thread plays its moves
+// while the UI thread may be saving the session (taken before sharedStateMutex)
+static std::mutex engineMutex;
+
 // JNI OnLoad - cache the JavaVM
 JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     javaVM = vm;
@@ -33,11 +61,43 @@ JNIEnv* attachThread() {
     return env;
 }
 
+// Publish the current game state into the shared buffer (seqlock writer)
+static void publishState() {
+    TRACE_SCOPE("publishState");
+    std::lock_guard<std::mutex> lock(sharedStateMutex);
+    if (sharedState == nullptr || gameEngine == nullptr) return;
+    
+    uint32_t sequence = __atomic_load_n(&sharedState->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&sharedState->sequence, sequence + 1, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    int board[BOARD_SQUARES];
+    gameEngine->getBoardState(board);
+    for (int i = 0; i < BOARD_SQUARES; i++) {
+        sharedState->board[i] = static_cast<int8_t>(board[i]);
+    }
+    
+    int blackScore, whiteScore, lastRow, lastCol;
+    gameEngine->getScores(&blackScore, &whiteScore);
+    gameEngine->getLastMove(&lastRow, &lastCol);
+    sharedState->currentPlayer = static_cast<int8_t>(gameEngine->getCurrentPlayer());
+    sharedState->lastMoveRow = static_cast<int8_t>(lastRow);
+    sharedState->lastMoveCol = static_cast<int8_t>(lastCol);
+    sharedState->winner = static_cast<int8_t>(gameEngine->getWinner());
+    sharedState->blackScore = static_cast<uint8_t>(blackScore);
+    sharedState->whiteScore = static_cast<uint8_t>(whiteScore);
+    sharedState->blackMoves = gameEngine->getValidMoveMask(BLACK);
+    sharedState->whiteMoves = gameEngine->getValidMoveMask(WHITE);
+    
+    __atomic_store_n(&sharedState->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
 extern "C" {
 
 // Initialize game engine
 JNIEXPORT void JNICALL
 Java_com_example_reversi_ReversiLib_initGame(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.initGame");
     if (gameEngine != nullptr) {
         delete gameEngine;
     }
@@ -47,33 +107,49 @@ Java_com_example_reversi_ReversiLib_initGame(JNIEnv* env, jobject thiz) {
         delete ai;
     }
     ai = new AI(gameEngine);
+    if (neuralEvaluator.isLoaded()) {
+        ai->setNeuralEvaluator(&neuralEvaluator);
+    }
+    if (solvedStore.isOpen()) {
+        ai->setSolvedStore(&solvedStore);
+    }
     
     // Cache the activity reference
     javaActivity = env->NewGlobalRef(thiz);
+    
+    publishState();
 }
 
 // Reset game
 JNIEXPORT void JNICALL
 Java_com_example_reversi_ReversiLib_resetGame(JNIEnv* env, jobject thiz, jint gameMode, jint difficulty) {
+    TRACE_SCOPE("jni.resetGame");
+    std::lock_guard<std::mutex> lock(engineMutex);
     if (gameEngine != nullptr) {
         gameEngine->initGame();
         
         if (ai != nullptr) {
             ai->setDifficulty(static_cast<AIDifficulty>(difficulty));
         }
+        publishState();
     }
 }
 
 // Make a player move
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_makeMove(JNIEnv* env, jobject thiz, jint row, jint col, jint player) {
+    TRACE_SCOPE("jni.makeMove");
+    std::lock_guard<std::mutex> lock(engineMutex);
     if (gameEngine == nullptr) return JNI_FALSE;
-    return gameEngine->makeMove(row, col, player) ? JNI_TRUE : JNI_FALSE;
+    if (!gameEngine->makeMove(row, col, player)) return JNI_FALSE;
+    publishState();
+    return JNI_TRUE;
 }
 
 // Check if a move is valid
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_canMove(JNIEnv* env, jobject thiz, jint row, jint col, jint player) {
+    TRACE_SCOPE("jni.canMove");
     if (gameEngine == nullptr) return JNI_FALSE;
     return gameEngine->canMove(row, col, player) ? JNI_TRUE : JNI_FALSE;
 }
@@ -81,6 +157,7 @@ Java_com_example_reversi_ReversiLib_canMove(JNIEnv* env, jobject thiz, jint row,
 // Check if player can move
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_playerCanMove(JNIEnv* env, jobject thiz, jint player) {
+    TRACE_SCOPE("jni.playerCanMove");
     if (gameEngine == nullptr) return JNI_FALSE;
     return gameEngine->playerCanMove(player) ? JNI_TRUE : JNI_FALSE;
 }
@@ -88,30 +165,42 @@ Java_com_example_reversi_ReversiLib_playerCanMove(JNIEnv* env, jobject thiz, jin
 // Pass turn
 JNIEXPORT void JNICALL
 Java_com_example_reversi_ReversiLib_passTurn(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.passTurn");
+    std::lock_guard<std::mutex> lock(engineMutex);
     if (gameEngine != nullptr) {
         gameEngine->passTurn();
+        publishState();
     }
 }
 
-// Get board state - returns flattened 64-element array
+// Get board size (squares per side)
+JNIEXPORT jint JNICALL
+Java_com_example_reversi_ReversiLib_getBoardSize(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.getBoardSize");
+    return GameEngine::SIZE;
+}
+
+// Get board state - returns flattened row-major array of getBoardSize()^2 squares
 JNIEXPORT jintArray JNICALL
 Java_com_example_reversi_ReversiLib_getBoardState(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.getBoardState");
     if (gameEngine == nullptr) {
-        jintArray result = env->NewIntArray(64);
+        jintArray result = env->NewIntArray(BOARD_SQUARES);
         return result;
     }
     
-    int board[64];
+    int board[BOARD_SQUARES];
     gameEngine->getBoardState(board);
     
-    jintArray result = env->NewIntArray(64);
-    env->SetIntArrayRegion(result, 0, 64, board);
+    jintArray result = env->NewIntArray(BOARD_SQUARES);
+    env->SetIntArrayRegion(result, 0, BOARD_SQUARES, board);
     return result;
 }
 
 // Get scores
 JNIEXPORT jintArray JNICALL
 Java_com_example_reversi_ReversiLib_getScores(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.getScores");
     if (gameEngine == nullptr) {
         jintArray result = env->NewIntArray(2);
         return result;
@@ -129,6 +218,7 @@ Java_com_example_reversi_ReversiLib_getScores(JNIEnv* env, jobject thiz) {
 // Get current player
 JNIEXPORT jint JNICALL
 Java_com_example_reversi_ReversiLib_getCurrentPlayer(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.getCurrentPlayer");
     if (gameEngine == nullptr) return 0;
     return gameEngine->getCurrentPlayer();
 }
@@ -136,28 +226,40 @@ Java_com_example_reversi_ReversiLib_getCurrentPlayer(JNIEnv* env, jobject thiz)
 // Set current player
 JNIEXPORT void JNICALL
 Java_com_example_reversi_ReversiLib_setCurrentPlayer(JNIEnv* env, jobject thiz, jint player) {
+    TRACE_SCOPE("jni.setCurrentPlayer");
+    std::lock_guard<std::mutex> lock(engineMutex);
     if (gameEngine != nullptr) {
         gameEngine->setCurrentPlayer(player);
+        publishState();
     }
 }
 
 // Undo move
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_undo(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.undo");
+    std::lock_guard<std::mutex> lock(engineMutex);
     if (gameEngine == nullptr) return JNI_FALSE;
-    return gameEngine->undo() ? JNI_TRUE : JNI_FALSE;
+    if (!gameEngine->undo()) return JNI_FALSE;
+    publishState();
+    return JNI_TRUE;
 }
 
 // Redo move
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_redo(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.redo");
+    std::lock_guard<std::mutex> lock(engineMutex);
     if (gameEngine == nullptr) return JNI_FALSE;
-    return gameEngine->redo() ? JNI_TRUE : JNI_FALSE;
+    if (!gameEngine->redo()) return JNI_FALSE;
+    publishState();
+    return JNI_TRUE;
 }
 
 // Can undo?
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_canUndo(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.canUndo");
     if (gameEngine == nullptr) return JNI_FALSE;
     return gameEngine->canUndo() ? JNI_TRUE : JNI_FALSE;
 }
@@ -165,6 +267,7 @@ Java_com_example_reversi_ReversiLib_canUndo(JNIEnv* env, jobject thiz) {
 // Can redo?
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_canRedo(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.canRedo");
     if (gameEngine == nullptr) return JNI_FALSE;
     return gameEngine->canRedo() ? JNI_TRUE : JNI_FALSE;
 }
@@ -172,6 +275,7 @@ Java_com_example_reversi_ReversiLib_canRedo(JNIEnv* env, jobject thiz) {
 // Is game over?
 JNIEXPORT jboolean JNICALL
 Java_com_example_reversi_ReversiLib_isGameOver(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.isGameOver");
     if (gameEngine == nullptr) return JNI_FALSE;
     return gameEngine->isGameOver() ? JNI_TRUE : JNI_FALSE;
 }
@@ -179,6 +283,7 @@ Java_com_example_reversi_ReversiLib_isGameOver(JNIEnv* env, jobject thiz) {
 // Get winner
 JNIEXPORT jint JNICALL
 Java_com_example_reversi_ReversiLib_getWinner(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.getWinner");
     if (gameEngine == nullptr) return -1;
     return gameEngine->getWinner();
 }
@@ -186,6 +291,7 @@ Java_com_example_reversi_ReversiLib_getWinner(JNIEnv* env, jobject thiz) {
 // Get AI move (returns int array with row and col)
 JNIEXPORT jintArray JNICALL
 Java_com_example_reversi_ReversiLib_getAIMove(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni.getAIMove");
     if (ai == nullptr || gameEngine == nullptr) {
         jintArray result = env->NewIntArray(2);
         jint init[2] = {-1, -1};
@@ -203,9 +309,150 @@ Java_com_example_reversi_ReversiLib_getAIMove(JNIEnv* env, jobject thiz) {
 // Get valid moves count for a player
 JNIEXPORT jint JNICALL
 Java_com_example_reversi_ReversiLib_getValidMovesCount(JNIEnv* env, jobject thiz, jint player) {
+    TRACE_SCOPE("jni.getValidMovesCount");
     if (gameEngine == nullptr) return 0;
     auto moves = gameEngine->getValidMoves(player);
     return static_cast<jint>(moves.size());
 }
 
+// Save the session to a byte array (includeCaches adds the AI's search caches)
+JNIEXPORT jbyteArray JNICALL
+Java_com_example_reversi_ReversiLib_saveSnapshot(JNIEnv* env, jobject thiz, jboolean includeCaches) {
+    TRACE_SCOPE("jni.saveSnapshot");
+    if (gameEngine == nullptr) return env->NewByteArray(0);
+    
+    std::vector<uint8_t> buffer;
+    {
+        std::lock_guard<std::mutex> lock(engineMutex);
+        saveSnapshot(*gameEngine, ai, includeCaches == JNI_TRUE, buffer);
+    }
+    
+    jbyteArray result = env->NewByteArray(static_cast<jsize>(buffer.size()));
+    env->SetByteArrayRegion(result, 0, static_cast<jsize>(buffer.size()),
+                            reinterpret_cast<const jbyte*>(buffer.data()));
+    return result;
+}
+
+// Restore the session from a byte array
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_loadSnapshot(JNIEnv* env, jobject thiz, jbyteArray data) {
+    TRACE_SCOPE("jni.loadSnapshot");
+    if (gameEngine == nullptr || data == nullptr) return JNI_FALSE;
+    
+    jsize length = env->GetArrayLength(data);
+    jbyte* bytes = env->GetByteArrayElements(data, nullptr);
+    if (bytes == nullptr) return JNI_FALSE;
+    
+    std::lock_guard<std::mutex> lock(engineMutex);
+    bool loaded = loadSnapshot(*gameEngine, ai, reinterpret_cast<const uint8_t*>(bytes), static_cast<size_t>(length));
+    env->ReleaseByteArrayElements(data, bytes, JNI_ABORT);
+    if (!loaded) return JNI_FALSE;
+    publishState();
+    return JNI_TRUE;
+}
+
+// Save the session to an open file descriptor
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_saveSnapshotToFd(JNIEnv* env, jobject thiz, jint fd, jboolean includeCaches) {
+    TRACE_SCOPE("jni.saveSnapshotToFd");
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (gameEngine == nullptr) return JNI_FALSE;
+    return saveSnapshotToFd(fd, *gameEngine, ai, includeCaches == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+// Restore the session from an open file descriptor
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_loadSnapshotFromFd(JNIEnv* env, jobject thiz, jint fd) {
+    TRACE_SCOPE("jni.loadSnapshotFromFd");
+    std::lock_guard<std::mutex> lock(engineMutex);
+    if (gameEngine == nullptr) return JNI_FALSE;
+    if (!loadSnapshotFromFd(fd, *gameEngine, ai)) return JNI_FALSE;
+    publishState();
+    return JNI_TRUE;
+}
+
+// Map an evaluation network file (see tools/nn_train) and use it for the AI's searches.
+// Unmaps the previous network: called on the AI thread, never during a search.
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_loadEvaluator(JNIEnv* env, jobject thiz, jstring path) {
+    TRACE_SCOPE("jni.loadEvaluator");
+    const char* chars = env->GetStringUTFChars(path, nullptr);
+    if (chars == nullptr) return JNI_FALSE;
+    std::string file(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    
+    // Detach the AI before the old mapping goes away
+    if (ai != nullptr) {
+        ai->setNeuralEvaluator(nullptr);
+    }
+    if (!neuralEvaluator.load(file.c_str())) return JNI_FALSE;
+    if (ai != nullptr) {
+        ai->setNeuralEvaluator(&neuralEvaluator);
+    }
+    return JNI_TRUE;
+}
+
+// Open (or create) the solved-position store and let the AI look up and add endgame solves.
+// Reads and may rewrite the whole file, and swaps the AI's store: called on the AI thread.
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_openSolvedStore(JNIEnv* env, jobject thiz, jstring path) {
+    TRACE_SCOPE("jni.openSolvedStore");
+    const char* chars = env->GetStringUTFChars(path, nullptr);
+    if (chars == nullptr) return JNI_FALSE;
+    std::string file(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    
+    if (ai != nullptr) {
+        ai->setSolvedStore(nullptr);
+    }
+    if (!solvedStore.open(file.c_str())) return JNI_FALSE;
+    
+    // Compaction is skipped while another process has the file open; on failure the old
+    // file stays in use
+    if (solvedStore.needsCompaction()) {
+        solvedStore.compact();
+    }
+    if (!solvedStore.isOpen()) return JNI_FALSE;
+    if (ai != nullptr) {
+        ai->setSolvedStore(&solvedStore);
+    }
+    return JNI_TRUE;
+}
+
+// Write the trace events recorded so far as Chrome trace JSON (builds with REVERSI_TRACE only)
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_writeTrace(JNIEnv* env, jobject thiz, jstring path) {
+    const char* chars = env->GetStringUTFChars(path, nullptr);
+    if (chars == nullptr) return JNI_FALSE;
+    bool written = writeTraceJson(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    return written ? JNI_TRUE : JNI_FALSE;
+}
+
+// Register the direct buffer the game state is published into
+JNIEXPORT jboolean JNICALL
+Java_com_example_reversi_ReversiLib_registerStateBuffer(JNIEnv* env, jobject thiz, jobject buffer) {
+    TRACE_SCOPE("jni.registerStateBuffer");
+    void* address = env->GetDirectBufferAddress(buffer);
+    if (address == nullptr ||
+        env->GetDirectBufferCapacity(buffer) < static_cast<jlong>(sizeof(SharedGameState)) ||
+        reinterpret_cast<uintptr_t>(address) % alignof(SharedGameState) != 0) {
+        return JNI_FALSE;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(sharedStateMutex);
+        if (sharedStateBuffer != nullptr) {
+            env->DeleteGlobalRef(sharedStateBuffer);
+        }
+        // Keep the buffer alive for as long as native code writes into it
+        sharedStateBuffer = env->NewGlobalRef(buffer);
+        sharedState = static_cast<SharedGameState*>(address);
+        sharedState->sequence = 0;
+    }
+    
+    publishState();
+    return JNI_TRUE;
+}
+
 } // extern "C"
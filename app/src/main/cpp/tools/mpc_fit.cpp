@@ -0,0 +1,248 @@
+// Offline fitting of Multi-ProbCut parameters.
+//
+// For every position in the set, the full-width search value is computed at each
+// depth up to --max-depth. For each game stage and (deep, shallow) depth pair used
+// by the search, a least-squares line  deep = a * shallow + b  is fitted and the
+// residual standard deviation is reported as sigma.
+//
+// Usage:
+//   mpc_fit [--positions FILE | --random N] [--seed S] [--max-depth D] [--out FILE] [--cpp]
+//
+// Position files hold one position per line: 64 characters ('X' = black, 'O' = white,
+// '-' = empty, row by row from a1) followed by the side to move ('X' or 'O').
+
+#include "AI.h"
+#include "GameEngine.h"
+#include "ProbCut.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Position {
+    int board[8][8];
+    int player;
+};
+
+// Running sums for one regression
+struct Regression {
+    long n = 0;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+    
+    void add(double x, double y) {
+        n++;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        syy += y * y;
+    }
+};
+
+// Fewest samples for which a fit is reported
+constexpr long MIN_SAMPLES = 20;
+
+// Search scores at or beyond this magnitude come from finished games
+constexpr int TERMINAL_SCORE = 1000;
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: mpc_fit [--positions FILE | --random N] [--seed S] "
+                 "[--max-depth D] [--out FILE] [--cpp]\n");
+}
+
+bool readPositions(const char* path, std::vector<Position>& positions) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return false;
+    
+    char line[256];
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        if (std::strlen(line) < 66 || line[0] == '#') continue;
+        
+        Position pos;
+        bool ok = true;
+        for (int i = 0; i < 64 && ok; i++) {
+            char c = line[i];
+            if (c == 'X' || c == 'x' || c == '*') pos.board[i / 8][i % 8] = BLACK;
+            else if (c == 'O' || c == 'o') pos.board[i / 8][i % 8] = WHITE;
+            else if (c == '-' || c == '.') pos.board[i / 8][i % 8] = EMPTY;
+            else ok = false;
+        }
+        char side = line[65];
+        if (!ok || (side != 'X' && side != 'O')) continue;
+        pos.player = (side == 'X') ? BLACK : WHITE;
+        positions.push_back(pos);
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Random playouts from the start position, stopped at a random disc count in each stage
+void generatePositions(int count, unsigned int seed, std::vector<Position>& positions) {
+    std::mt19937 rng(seed);
+    GameEngine engine;
+    
+    for (int i = 0; i < count; i++) {
+        int stage = i % PROBCUT_STAGES;
+        int targetDiscs = 4 + stage * 10 + static_cast<int>(rng() % 10);
+        if (targetDiscs > 62) targetDiscs = 62;
+        
+        engine.initGame();
+        bool reached = true;
+        for (int discs = 4; discs < targetDiscs; discs++) {
+            int player = engine.getCurrentPlayer();
+            auto moves = engine.getValidMoves(player);
+            if (moves.empty()) {
+                engine.passTurn();
+                moves = engine.getValidMoves(engine.getCurrentPlayer());
+                if (moves.empty()) {
+                    reached = false;
+                    break;
+                }
+                player = engine.getCurrentPlayer();
+            }
+            auto move = moves[rng() % moves.size()];
+            engine.makeMove(move.first, move.second, player);
+        }
+        
+        if (!reached || engine.getValidMoves(engine.getCurrentPlayer()).empty()) {
+            i--;    // Finished game or pass position; draw another one
+            continue;
+        }
+        
+        Position pos;
+        engine.getBoardState(&pos.board[0][0]);
+        pos.player = engine.getCurrentPlayer();
+        positions.push_back(pos);
+    }
+}
+
+int countDiscs(const Position& pos) {
+    int discs = 0;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            if (pos.board[i][j] != EMPTY) discs++;
+        }
+    }
+    return discs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* positionsPath = nullptr;
+    const char* outPath = nullptr;
+    int randomCount = 0;
+    unsigned int seed = 1;
+    int maxDepth = 8;
+    bool emitCpp = false;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--positions" && hasValue) positionsPath = argv[++i];
+        else if (arg == "--random" && hasValue) randomCount = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (arg == "--max-depth" && hasValue) maxDepth = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--cpp") emitCpp = true;
+        else {
+            usage();
+            return 2;
+        }
+    }
+    
+    if (maxDepth < PROBCUT_MIN_DEPTH || maxDepth > PROBCUT_MAX_DEPTH) {
+        std::fprintf(stderr, "--max-depth must be in [%d, %d]\n", PROBCUT_MIN_DEPTH, PROBCUT_MAX_DEPTH);
+        return 2;
+    }
+    
+    std::vector<Position> positions;
+    if (positionsPath != nullptr) {
+        if (!readPositions(positionsPath, positions)) {
+            std::fprintf(stderr, "cannot read %s\n", positionsPath);
+            return 1;
+        }
+    } else if (randomCount > 0) {
+        generatePositions(randomCount, seed, positions);
+    } else {
+        usage();
+        return 2;
+    }
+    
+    GameEngine engine;
+    AI ai(&engine);
+    
+    Regression fits[PROBCUT_STAGES][PROBCUT_MAX_DEPTH + 1][PROBCUT_TRIES];
+    
+    for (size_t p = 0; p < positions.size(); p++) {
+        Position& pos = positions[p];
+        int stage = getProbCutStage(countDiscs(pos));
+        
+        // Full-width values at every depth (index = depth)
+        std::vector<int> values(maxDepth + 1, 0);
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            values[depth] = ai.searchPosition(pos.board, pos.player, depth, false);
+        }
+        
+        for (int depth = PROBCUT_MIN_DEPTH; depth <= maxDepth; depth++) {
+            for (int attempt = 0; attempt < PROBCUT_TRIES; attempt++) {
+                int shallow = getProbCutShallowDepth(depth, attempt);
+                if (shallow == 0) continue;
+                if (std::abs(values[depth]) >= TERMINAL_SCORE || std::abs(values[shallow]) >= TERMINAL_SCORE) continue;
+                fits[stage][depth][attempt].add(values[shallow], values[depth]);
+            }
+        }
+        
+        std::fprintf(stderr, "\r%zu/%zu positions", p + 1, positions.size());
+    }
+    std::fprintf(stderr, "\n");
+    
+    FILE* out = stdout;
+    if (outPath != nullptr) {
+        out = std::fopen(outPath, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot write %s\n", outPath);
+            return 1;
+        }
+    }
+    
+    if (!emitCpp) {
+        std::fprintf(out, "# stage depth shallow a b sigma  (n samples)\n");
+    }
+    
+    for (int stage = 0; stage < PROBCUT_STAGES; stage++) {
+        for (int depth = PROBCUT_MIN_DEPTH; depth <= maxDepth; depth++) {
+            for (int attempt = 0; attempt < PROBCUT_TRIES; attempt++) {
+                const Regression& r = fits[stage][depth][attempt];
+                if (r.n < MIN_SAMPLES) continue;
+                
+                double n = static_cast<double>(r.n);
+                double varX = r.sxx - r.sx * r.sx / n;
+                double covXY = r.sxy - r.sx * r.sy / n;
+                if (varX <= 0.0) continue;
+                
+                double a = covXY / varX;
+                double b = (r.sy - a * r.sx) / n;
+                double sse = r.syy - 2 * a * r.sxy - 2 * b * r.sy + a * a * r.sxx + 2 * a * b * r.sx + n * b * b;
+                double sigma = std::sqrt(std::max(sse, 0.0) / (n - 2));
+                if (a <= 0.0 || sigma <= 0.0) continue;
+                
+                int shallow = getProbCutShallowDepth(depth, attempt);
+                if (emitCpp) {
+                    std::fprintf(out, "    {%d, %2d, %2d, %.3f, %.1f, %.1f},\n", stage, depth, shallow, a, b, sigma);
+                } else {
+                    std::fprintf(out, "%d %d %d %.4f %.2f %.2f  # n=%ld\n", stage, depth, shallow, a, b, sigma, r.n);
+                }
+            }
+        }
+    }
+    
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
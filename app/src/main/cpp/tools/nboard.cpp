@@ -0,0 +1,342 @@
+// Headless engine speaking the NBoard protocol (version 2) on stdin/stdout.
+//
+// Wraps GameEngine/AI so external GUIs and batch analysis scripts can drive the native
+// engine without the Android stack. One command per line; searches run on a worker
+// thread so "stop", "ping" and "quit" interrupt them.
+//
+// Commands:
+//   nboard 2                  handshake, replies "set myname ..."
+//   set depth D               maximum search depth (plies)
+//   set game GGF              set the position from a GGF game record
+//   set contempt C            accepted and ignored
+//   set movetime MS           time limit per go/hint in milliseconds, 0 = none (extension)
+//   move MOVE[/EVAL/TIME]     play a move ("F5", "PA" to pass)
+//   go                        search, reply "=== MOVE/EVAL/TIME"
+//   hint N                    analyze the best N moves, "search MOVE EVAL 0 DEPTH" per iteration
+//   stop                      end the current go/hint early (extension)
+//   ping N                    stop any search, reply "pong N"
+//   learn                     reply "learned"
+//   quit                      exit
+//
+// With --store, exact endgame results are looked up in and added to a solved-position file
+// (see SolvedStore.h); several engine processes may share one.
+//
+// Usage:
+//   nboard [--no-probcut] [--store FILE]
+
+#include "AI.h"
+#include "GameEngine.h"
+#include "SolvedStore.h"
+#include "Solver.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr int MAX_DEPTH = 60;
+constexpr int DEFAULT_DEPTH = 12;
+constexpr const char* ENGINE_NAME = "Reversi";
+
+// Protocol output (the worker and the command loop both write)
+class Output {
+private:
+    std::mutex mutex;
+
+public:
+    void line(const std::string& text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::fputs(text.c_str(), stdout);
+        std::fputc('\n', stdout);
+        std::fflush(stdout);
+    }
+};
+
+// "F5" style square name, "PA" for a pass
+std::string moveName(int row, int col) {
+    if (row < 0 || col < 0) return "PA";
+    std::string name(1, static_cast<char>('A' + col));
+    return name + std::to_string(row + 1);
+}
+
+// Parse a square name (any case, an optional "/eval/time" suffix is ignored); false for a pass
+bool parseMove(const std::string& text, int* row, int* col, bool* pass) {
+    std::string move = text.substr(0, text.find('/'));
+    if (move.empty()) return false;
+    
+    std::string upper;
+    for (char c : move) upper += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    *pass = (upper == "PA" || upper == "PASS");
+    if (*pass) return true;
+    
+    if (upper.size() < 2 || upper[0] < 'A' || upper[0] >= 'A' + GameEngine::SIZE) return false;
+    int number = 0;
+    for (size_t i = 1; i < upper.size(); i++) {
+        if (!std::isdigit(static_cast<unsigned char>(upper[i]))) return false;
+        number = number * 10 + (upper[i] - '0');
+    }
+    if (number < 1 || number > GameEngine::SIZE) return false;
+    *row = number - 1;
+    *col = upper[0] - 'A';
+    return true;
+}
+
+// Play a move for `player`, passing first if the side to move has no legal move
+bool playMove(GameEngine& engine, int player, const std::string& text) {
+    int row = -1;
+    int col = -1;
+    bool pass = false;
+    if (!parseMove(text, &row, &col, &pass)) return false;
+    
+    int current = engine.getCurrentPlayer();
+    if (player != current) {
+        if (engine.playerCanMove(current)) return false;
+        engine.passTurn();
+    }
+    if (pass) {
+        if (engine.playerCanMove(player)) return false;
+        engine.passTurn();
+        return true;
+    }
+    if (!engine.playerCanMove(player)) {
+        engine.passTurn();
+        player = engine.getCurrentPlayer();
+    }
+    return engine.makeMove(row, col, player);
+}
+
+// Set the position from a GGF record: the BO[] start position followed by the B[]/W[] moves
+bool loadGgf(GameEngine& engine, const std::string& ggf) {
+    constexpr int N = GameEngine::SIZE;
+    GameEngine parsed;
+    bool haveBoard = false;
+    
+    size_t i = ggf.find(';');
+    if (i == std::string::npos) return false;
+    i++;
+    while (i < ggf.size()) {
+        if (!std::isupper(static_cast<unsigned char>(ggf[i]))) {
+            i++;
+            continue;
+        }
+        size_t tagStart = i;
+        while (i < ggf.size() && std::isupper(static_cast<unsigned char>(ggf[i]))) i++;
+        if (i >= ggf.size() || ggf[i] != '[') continue;
+        std::string tag = ggf.substr(tagStart, i - tagStart);
+        size_t close = ggf.find(']', i);
+        if (close == std::string::npos) return false;
+        std::string value = ggf.substr(i + 1, close - i - 1);
+        i = close + 1;
+        
+        if (tag == "BO") {
+            std::istringstream stream(value);
+            int size = 0;
+            std::string squares;
+            std::string token;
+            stream >> size;
+            if (size != N) return false;
+            while (static_cast<int>(squares.size()) < N * N && stream >> token) squares += token;
+            std::string side;
+            if (static_cast<int>(squares.size()) != N * N || !(stream >> side)) return false;
+            
+            int board[N * N];
+            for (int s = 0; s < N * N; s++) {
+                char c = squares[s];
+                if (c == '*' || c == 'X' || c == 'x' || c == 'B' || c == 'b') board[s] = BLACK;
+                else if (c == 'O' || c == 'o' || c == 'W' || c == 'w') board[s] = WHITE;
+                else if (c == '-' || c == '.') board[s] = EMPTY;
+                else return false;
+            }
+            int player = (side == "O" || side == "W" || side == "w") ? WHITE : BLACK;
+            if (!parsed.setPosition(board, player)) return false;
+            haveBoard = true;
+        } else if (tag == "B" || tag == "W") {
+            if (!haveBoard || !playMove(parsed, tag == "B" ? BLACK : WHITE, value)) return false;
+        }
+    }
+    if (!haveBoard) return false;
+    
+    // Only touch the live engine once the whole record is valid
+    int board[N * N];
+    parsed.getBoardState(board);
+    return engine.setPosition(board, parsed.getCurrentPlayer());
+}
+
+class Session {
+private:
+    GameEngine engine;
+    AI ai;
+    Output& out;
+    
+    int maxDepth = DEFAULT_DEPTH;
+    int moveTimeMs = 0;
+    
+    std::thread worker;
+    std::atomic<bool> stopRequested{false};
+    
+    // Wait for the running search (if any) to finish
+    void join() {
+        if (worker.joinable()) worker.join();
+    }
+    
+    void interrupt() {
+        stopRequested = true;
+        join();
+    }
+    
+    void startGo() {
+        stopRequested = false;
+        worker = std::thread([this]() {
+            auto start = std::chrono::steady_clock::now();
+            AnalysisResult result = ai.analyze(maxDepth, moveTimeMs, 1, &stopRequested, nullptr);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            
+            char text[64];
+            std::snprintf(text, sizeof(text), "nodestats %llu %.3f",
+                          static_cast<unsigned long long>(result.nodes), seconds);
+            out.line(text);
+            if (result.moves.empty()) {
+                out.line("=== PA");
+                return;
+            }
+            const AnalyzedMove& best = result.moves[0];
+            std::snprintf(text, sizeof(text), "=== %s/%.2f/%.3f", moveName(best.row, best.col).c_str(),
+                          AI::scoreInDiscs(best.score), seconds);
+            out.line(text);
+        });
+    }
+    
+    void startHint(int count) {
+        stopRequested = false;
+        worker = std::thread([this, count]() {
+            out.line("status Analyzing");
+            ai.analyze(maxDepth, moveTimeMs, count, &stopRequested, [this, count](const AnalysisResult& result) {
+                int shown = std::min(count, static_cast<int>(result.moves.size()));
+                for (int i = 0; i < shown; i++) {
+                    const AnalyzedMove& move = result.moves[i];
+                    char text[64];
+                    std::snprintf(text, sizeof(text), "search %s %.2f 0 %d", moveName(move.row, move.col).c_str(),
+                                  AI::scoreInDiscs(move.score), result.depth);
+                    out.line(text);
+                }
+            });
+            out.line("status");
+        });
+    }
+
+public:
+    Session(Output& output, bool probCut, SolvedStore* store) : ai(&engine), out(output) {
+        ai.setDifficulty(AIDifficulty::EXPERT);
+        ai.setProbCutEnabled(probCut);
+        ai.setSolvedStore(store);
+        ai.setSolverTableBits(SOLVER_TABLE_BITS);
+    }
+    
+    ~Session() {
+        interrupt();
+    }
+    
+    // Handle one command line; returns false on quit
+    bool handle(const std::string& line) {
+        std::istringstream stream(line);
+        std::string command;
+        if (!(stream >> command)) return true;
+        
+        if (command == "stop") {
+            interrupt();
+            return true;
+        }
+        if (command == "quit") {
+            interrupt();
+            return false;
+        }
+        if (command == "ping") {
+            std::string id;
+            stream >> id;
+            interrupt();
+            out.line("pong " + id);
+            return true;
+        }
+        
+        // Everything else applies after the running search
+        join();
+        
+        if (command == "nboard") {
+            out.line(std::string("set myname ") + ENGINE_NAME);
+        } else if (command == "set") {
+            std::string key;
+            stream >> key;
+            if (key == "depth") {
+                int depth = 0;
+                if (stream >> depth) maxDepth = std::max(1, std::min(MAX_DEPTH, depth));
+            } else if (key == "movetime") {
+                int ms = 0;
+                if (stream >> ms) moveTimeMs = std::max(0, ms);
+            } else if (key == "game") {
+                std::string ggf;
+                std::getline(stream, ggf);
+                if (!loadGgf(engine, ggf)) {
+                    std::fprintf(stderr, "nboard: invalid game: %s\n", ggf.c_str());
+                }
+            } else if (key != "contempt") {
+                std::fprintf(stderr, "nboard: unknown setting: %s\n", key.c_str());
+            }
+        } else if (command == "move") {
+            std::string move;
+            stream >> move;
+            if (!playMove(engine, engine.getCurrentPlayer(), move)) {
+                std::fprintf(stderr, "nboard: illegal move: %s\n", move.c_str());
+            }
+        } else if (command == "go") {
+            startGo();
+        } else if (command == "hint") {
+            int count = 1;
+            stream >> count;
+            startHint(std::max(1, count));
+        } else if (command == "learn") {
+            out.line("learned");
+        } else {
+            std::fprintf(stderr, "nboard: unknown command: %s\n", command.c_str());
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool probCut = true;
+    const char* storePath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--no-probcut") probCut = false;
+        else if (arg == "--store" && i + 1 < argc) storePath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: nboard [--no-probcut] [--store FILE]\n");
+            return 2;
+        }
+    }
+    
+    SolvedStore store;
+    if (storePath != nullptr && !store.open(storePath)) {
+        std::fprintf(stderr, "nboard: cannot open solved-position store %s\n", storePath);
+        return 1;
+    }
+    
+    Output out;
+    Session session(out, probCut, store.isOpen() ? &store : nullptr);
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!session.handle(line)) break;
+    }
+    return 0;
+}
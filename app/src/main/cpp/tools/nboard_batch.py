@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Batch position analysis with a pool of local NBoard engine processes.
+
+Each input line is a move sequence from the standard start ("f5d6c3") or a GGF
+game record. Every worker keeps one `nboard` process and feeds it positions;
+results are written as tab-separated lines in input order:
+
+    position  best-move  eval  seconds  nodes
+
+Usage:
+    nboard_batch.py --engine build-host/tools/nboard [--jobs J] [--depth D]
+                    [--movetime MS] [--no-probcut] [--store FILE] POSITIONS [OUTPUT]
+
+With --store, all engines share one solved-position file: endgames solved earlier (in
+this run or a previous one) are looked up, and new solves are appended. Compact it
+afterwards with `solved-store --compact FILE`.
+"""
+
+import argparse
+import concurrent.futures
+import os
+import re
+import subprocess
+import sys
+import threading
+
+START_GGF = ("(;GM[Othello]PC[batch]TY[8]"
+             "BO[8 ---------------------------O*------*O--------------------------- *];)")
+
+
+class Engine:
+    """One engine process speaking NBoard over pipes."""
+
+    def __init__(self, command):
+        self.process = subprocess.Popen(command, stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                        text=True, bufsize=1)
+        self.pings = 0
+        self.send("nboard 2")
+        self.sync()
+
+    def send(self, line):
+        self.process.stdin.write(line + "\n")
+        self.process.stdin.flush()
+
+    def read(self):
+        line = self.process.stdout.readline()
+        if not line:
+            raise RuntimeError("engine exited")
+        return line.strip()
+
+    def sync(self):
+        """Wait until every command sent so far has been processed."""
+        self.pings += 1
+        self.send("ping %d" % self.pings)
+        while self.read() != "pong %d" % self.pings:
+            pass
+
+    def analyze(self, position):
+        if position.startswith("("):
+            self.send("set game " + position)
+        else:
+            self.send("set game " + START_GGF)
+            for move in re.findall(r"[a-jA-J]\d+", position):
+                self.send("move " + move)
+        self.send("go")
+
+        nodes = 0
+        while True:
+            line = self.read()
+            if line.startswith("nodestats "):
+                nodes = int(line.split()[1])
+            elif line.startswith("=== "):
+                fields = line[4:].split("/") + ["", ""]
+                return fields[0], fields[1], fields[2], nodes
+
+    def close(self):
+        self.send("quit")
+        self.process.stdin.close()
+        self.process.wait()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Analyze positions with local NBoard engines")
+    parser.add_argument("--engine", required=True, help="path to the nboard executable")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1, help="engine processes")
+    parser.add_argument("--depth", type=int, default=12, help="search depth per position")
+    parser.add_argument("--movetime", type=int, default=0, help="time limit per position (ms)")
+    parser.add_argument("--no-probcut", action="store_true", help="full-width search")
+    parser.add_argument("--store", help="solved-position file shared by the engines")
+    parser.add_argument("positions", help="file with one move sequence or GGF record per line")
+    parser.add_argument("output", nargs="?", help="result file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.positions) as source:
+        positions = [line.strip() for line in source if line.strip() and not line.startswith("#")]
+
+    command = [args.engine] + (["--no-probcut"] if args.no_probcut else [])
+    if args.store:
+        command += ["--store", args.store]
+    local = threading.local()
+    engines = []
+    engines_lock = threading.Lock()
+
+    def analyze(position):
+        if not hasattr(local, "engine"):
+            local.engine = Engine(command)
+            local.engine.send("set depth %d" % args.depth)
+            local.engine.send("set movetime %d" % args.movetime)
+            with engines_lock:
+                engines.append(local.engine)
+        return local.engine.analyze(position)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+            for position, (move, score, seconds, nodes) in zip(positions, pool.map(analyze, positions)):
+                out.write("%s\t%s\t%s\t%s\t%d\n" % (position, move, score, seconds, nodes))
+                out.flush()
+    finally:
+        for engine in engines:
+            engine.close()
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,199 @@
+// Evaluation throughput: the position table against the network (see NeuralEval.h).
+//
+// On a reproducible set of random playout positions, measures evaluations per second for
+// the table evaluation, the network from scratch (refresh + evaluate), the network updated
+// for one move (applyMove + evaluate) and the scalar reference, checks that the vector
+// kernels match the reference exactly, and compares fixed-depth search speed.
+//
+// Usage:
+//   nn-bench --weights FILE [--positions N] [--depth D] [--seed S]
+
+#include "AI.h"
+#include "Bitboard.h"
+#include "GameEngine.h"
+#include "NeuralEval.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Board = Bitboard<NN_BOARD_SIZE>;
+
+struct Position {
+    int board[8][8];
+    int player;
+    uint64_t black;
+    uint64_t white;
+    int move;           // a legal move for `player`
+    uint64_t flipped;   // discs it flips
+};
+
+// Passes over the position set per timed kernel
+constexpr int REPEATS = 200;
+
+void usage() {
+    std::fprintf(stderr, "usage: nn-bench --weights FILE [--positions N] [--depth D] [--seed S]\n");
+}
+
+// Random playout positions where the side to move has a move
+std::vector<Position> generatePositions(int count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    GameEngine engine;
+    std::vector<Position> positions;
+    
+    while (static_cast<int>(positions.size()) < count) {
+        int targetDiscs = 8 + static_cast<int>(rng() % 48);
+        engine.initGame();
+        for (int discs = 4; discs < targetDiscs; discs++) {
+            int player = engine.getCurrentPlayer();
+            auto moves = engine.getValidMoves(player);
+            if (moves.empty()) break;
+            auto move = moves[rng() % moves.size()];
+            engine.makeMove(move.first, move.second, player);
+        }
+        Position pos;
+        pos.player = engine.getCurrentPlayer();
+        auto moves = engine.getValidMoves(pos.player);
+        if (moves.empty()) continue;
+        
+        engine.getBoardState(&pos.board[0][0]);
+        Board::fromBoard(&pos.board[0][0], BLACK, &pos.black, &pos.white);
+        auto move = moves[rng() % moves.size()];
+        pos.move = move.first * 8 + move.second;
+        uint64_t own = (pos.player == BLACK) ? pos.black : pos.white;
+        uint64_t other = (pos.player == BLACK) ? pos.white : pos.black;
+        pos.flipped = Board::flips(own, other, pos.move);
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+template <typename Kernel>
+double evalsPerSecond(size_t count, Kernel kernel, long* checksum) {
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for (int r = 0; r < REPEATS; r++) {
+        for (size_t i = 0; i < count; i++) sum += kernel(i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    *checksum = sum;
+    return REPEATS * count / seconds;
+}
+
+double searchNodesPerSecond(AI& ai, std::vector<Position>& positions, int depth, uint64_t* nodes) {
+    auto start = std::chrono::steady_clock::now();
+    *nodes = 0;
+    for (Position& pos : positions) {
+        ai.clearCache();
+        ai.searchPosition(pos.board, pos.player, depth, false);
+        *nodes += ai.getNodeCount();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return *nodes / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* weightsPath = nullptr;
+    int positionCount = 1000;
+    int depth = 6;
+    unsigned int seed = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--weights" && hasValue) weightsPath = argv[++i];
+        else if (arg == "--positions" && hasValue) positionCount = std::atoi(argv[++i]);
+        else if (arg == "--depth" && hasValue) depth = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (weightsPath == nullptr || positionCount < 1 || depth < 1) {
+        usage();
+        return 2;
+    }
+    
+    NeuralEvaluator evaluator;
+    if (!evaluator.load(weightsPath)) {
+        std::fprintf(stderr, "cannot load %s\n", weightsPath);
+        return 1;
+    }
+    std::vector<Position> positions = generatePositions(positionCount, seed);
+    size_t count = positions.size();
+    
+    // The vector kernels must reproduce the reference bit for bit, incrementally too
+    int mismatches = 0;
+    for (const Position& pos : positions) {
+        NNAccumulator fast;
+        NNAccumulator reference;
+        evaluator.refresh(fast, pos.black, pos.white);
+        evaluator.refreshReference(reference, pos.black, pos.white);
+        if (std::memcmp(fast.values, reference.values, sizeof(fast.values)) != 0 ||
+            evaluator.evaluate(fast) != evaluator.evaluateReference(reference)) {
+            mismatches++;
+            continue;
+        }
+        
+        uint64_t moveBit = 1ULL << pos.move;
+        uint64_t black = (pos.player == BLACK) ? pos.black | moveBit | pos.flipped : pos.black & ~pos.flipped;
+        uint64_t white = (pos.player == WHITE) ? pos.white | moveBit | pos.flipped : pos.white & ~pos.flipped;
+        evaluator.applyMove(fast, pos.player, pos.move, pos.flipped);
+        evaluator.refreshReference(reference, black, white);
+        if (std::memcmp(fast.values, reference.values, sizeof(fast.values)) != 0) mismatches++;
+    }
+    
+    GameEngine engine;
+    AI ai(&engine);
+    long checksum = 0;
+    
+    std::printf("%zu positions, %s kernels, %d mismatches against the scalar reference\n", count,
+                evaluator.kernelName(), mismatches);
+    
+    double table = evalsPerSecond(count, [&](size_t i) {
+        return ai.evaluateBoard(positions[i].board, WHITE);
+    }, &checksum);
+    std::printf("table evaluation        %12.0f evals/s\n", table);
+    
+    double refresh = evalsPerSecond(count, [&](size_t i) {
+        NNAccumulator accumulator;
+        evaluator.refresh(accumulator, positions[i].black, positions[i].white);
+        return evaluator.evaluate(accumulator);
+    }, &checksum);
+    std::printf("network, from scratch   %12.0f evals/s\n", refresh);
+    
+    std::vector<NNAccumulator> accumulators(count);
+    for (size_t i = 0; i < count; i++) evaluator.refresh(accumulators[i], positions[i].black, positions[i].white);
+    double incremental = evalsPerSecond(count, [&](size_t i) {
+        NNAccumulator accumulator = accumulators[i];
+        evaluator.applyMove(accumulator, positions[i].player, positions[i].move, positions[i].flipped);
+        return evaluator.evaluate(accumulator);
+    }, &checksum);
+    std::printf("network, one move       %12.0f evals/s\n", incremental);
+    
+    double reference = evalsPerSecond(count, [&](size_t i) {
+        NNAccumulator accumulator;
+        evaluator.refreshReference(accumulator, positions[i].black, positions[i].white);
+        return evaluator.evaluateReference(accumulator);
+    }, &checksum);
+    std::printf("network, scalar         %12.0f evals/s\n", reference);
+    
+    uint64_t tableNodes = 0;
+    uint64_t networkNodes = 0;
+    double tableSearch = searchNodesPerSecond(ai, positions, depth, &tableNodes);
+    ai.setNeuralEvaluator(&evaluator);
+    double networkSearch = searchNodesPerSecond(ai, positions, depth, &networkNodes);
+    std::printf("depth %d search: table %.0f nodes/s (%llu nodes), network %.0f nodes/s (%llu nodes)\n", depth,
+                tableSearch, static_cast<unsigned long long>(tableNodes), networkSearch,
+                static_cast<unsigned long long>(networkNodes));
+    
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,392 @@
+// Offline training of the evaluation network (see NeuralEval.h).
+//
+// Positions come from random playouts and are labelled by the engine's own search
+// (the average of depths D-1 and D, which cancels most of the odd/even swing), from
+// White's point of view. Every position is used in all 8 board symmetries. The network
+// is trained in floating point with Adam, clipped to the ranges the integer layers can
+// hold, quantized, written, and reloaded to measure the integer network's error on a
+// held-out set.
+//
+// Usage:
+//   nn-train [--positions N] [--depth D] [--epochs E] [--seed S] [--threads T] [--out FILE]
+
+#include "AI.h"
+#include "Bitboard.h"
+#include "GameEngine.h"
+#include "NeuralEval.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int SQUARES = NN_BOARD_SIZE * NN_BOARD_SIZE;
+
+// Labels stay below proven results (the search scores those 1000 per disc)
+constexpr int LABEL_LIMIT = 999;
+
+// Share of the positions held out for validation
+constexpr int HOLDOUT_EVERY = 20;
+
+constexpr int BATCH_SIZE = 256;
+constexpr float LEARNING_RATE = 0.001f;
+constexpr float ADAM_BETA1 = 0.9f;
+constexpr float ADAM_BETA2 = 0.999f;
+constexpr float ADAM_EPSILON = 1e-8f;
+
+// Largest weights the integer layers can hold: the first layer must keep 64 columns plus the
+// bias inside int16, the others must fit int8 at NN_WEIGHT_ONE
+constexpr float INPUT_WEIGHT_LIMIT = 3.9f;
+constexpr float INT8_WEIGHT_LIMIT = 127.0f / NN_WEIGHT_ONE;
+
+// Parameter layout of the float network
+constexpr int W1 = 0;
+constexpr int B1 = W1 + NN_INPUTS * NN_HIDDEN1;
+constexpr int W2 = B1 + NN_HIDDEN1;
+constexpr int B2 = W2 + NN_HIDDEN2 * NN_HIDDEN1;
+constexpr int W3 = B2 + NN_HIDDEN2;
+constexpr int B3 = W3 + NN_HIDDEN2;
+constexpr int PARAMETERS = B3 + 1;
+
+struct Sample {
+    uint64_t black;
+    uint64_t white;
+    float target;   // White's point of view in network units (NN_EVAL_SCALE points)
+};
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: nn-train [--positions N] [--depth D] [--epochs E] [--seed S] "
+                 "[--threads T] [--out FILE]\n");
+}
+
+// Random playout positions with the side to move able to move
+void generatePositions(int count, unsigned int seed, std::vector<int>& boards, std::vector<int>& players) {
+    std::mt19937 rng(seed);
+    GameEngine engine;
+    
+    while (static_cast<int>(players.size()) < count) {
+        int targetDiscs = 5 + static_cast<int>(rng() % (SQUARES - 6));
+        engine.initGame();
+        bool reached = true;
+        for (int discs = 4; discs < targetDiscs; discs++) {
+            int player = engine.getCurrentPlayer();
+            auto moves = engine.getValidMoves(player);
+            if (moves.empty()) {
+                engine.passTurn();
+                player = engine.getCurrentPlayer();
+                moves = engine.getValidMoves(player);
+                if (moves.empty()) {
+                    reached = false;
+                    break;
+                }
+            }
+            auto move = moves[rng() % moves.size()];
+            engine.makeMove(move.first, move.second, player);
+        }
+        if (!reached || !engine.playerCanMove(engine.getCurrentPlayer())) continue;
+        
+        int board[SQUARES];
+        engine.getBoardState(board);
+        boards.insert(boards.end(), board, board + SQUARES);
+        players.push_back(engine.getCurrentPlayer());
+    }
+}
+
+// Search labels from White's point of view, one AI per thread
+std::vector<int> labelPositions(const std::vector<int>& boards, const std::vector<int>& players, int depth,
+                                int threads) {
+    std::vector<int> labels(players.size());
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    
+    auto work = [&]() {
+        GameEngine engine;
+        AI ai(&engine);
+        for (size_t i = next++; i < players.size(); i = next++) {
+            int board[NN_BOARD_SIZE][NN_BOARD_SIZE];
+            std::copy(&boards[i * SQUARES], &boards[i * SQUARES] + SQUARES, &board[0][0]);
+            int sum = ai.searchPosition(board, players[i], depth, false);
+            if (depth > 1) sum += ai.searchPosition(board, players[i], depth - 1, false);
+            int value = (depth > 1) ? sum / 2 : sum;
+            if (players[i] == BLACK) value = -value;
+            labels[i] = std::max(-LABEL_LIMIT, std::min(LABEL_LIMIT, value));
+            
+            size_t finished = ++done;
+            if (finished % 1000 == 0) std::fprintf(stderr, "\rlabelled %zu/%zu", finished, players.size());
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(work);
+    work();
+    for (auto& thread : pool) thread.join();
+    std::fprintf(stderr, "\rlabelled %zu/%zu\n", players.size(), players.size());
+    return labels;
+}
+
+// Square index under one of the 8 symmetries of the board
+int transformSquare(int square, int symmetry) {
+    int row = square / NN_BOARD_SIZE;
+    int col = square % NN_BOARD_SIZE;
+    if (symmetry & 1) col = NN_BOARD_SIZE - 1 - col;
+    if (symmetry & 2) row = NN_BOARD_SIZE - 1 - row;
+    if (symmetry & 4) std::swap(row, col);
+    return row * NN_BOARD_SIZE + col;
+}
+
+uint64_t transformDiscs(uint64_t discs, int symmetry) {
+    uint64_t result = 0;
+    for (uint64_t rest = discs; rest != 0; rest &= rest - 1) {
+        result |= 1ULL << transformSquare(__builtin_ctzll(rest), symmetry);
+    }
+    return result;
+}
+
+class Trainer {
+private:
+    std::vector<float> params;
+    std::vector<float> gradient;
+    std::vector<float> moment1;
+    std::vector<float> moment2;
+    int steps = 0;
+    
+    // Activations of the last forward pass
+    float sum1[NN_HIDDEN1];
+    float hidden1[NN_HIDDEN1];
+    float sum2[NN_HIDDEN2];
+    float hidden2[NN_HIDDEN2];
+    int features[SQUARES];
+    int featureCount = 0;
+    
+    static float clip(float value) {
+        return std::max(0.0f, std::min(1.0f, value));
+    }
+
+public:
+    explicit Trainer(unsigned int seed)
+        : params(PARAMETERS), gradient(PARAMETERS, 0.0f), moment1(PARAMETERS, 0.0f), moment2(PARAMETERS, 0.0f) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> small(-0.1f, 0.1f);
+        std::uniform_real_distribution<float> wide(-0.25f, 0.25f);
+        for (int i = W1; i < B1; i++) params[i] = small(rng);
+        for (int i = B1; i < W2; i++) params[i] = 0.5f;
+        for (int i = W2; i < B2; i++) params[i] = wide(rng);
+        for (int i = B2; i < W3; i++) params[i] = 0.25f;
+        for (int i = W3; i < B3; i++) params[i] = wide(rng);
+        params[B3] = 0.0f;
+    }
+    
+    float forward(uint64_t black, uint64_t white) {
+        featureCount = 0;
+        for (uint64_t rest = black; rest != 0; rest &= rest - 1) {
+            features[featureCount++] = NeuralEvaluator::featureIndex(BLACK, __builtin_ctzll(rest));
+        }
+        for (uint64_t rest = white; rest != 0; rest &= rest - 1) {
+            features[featureCount++] = NeuralEvaluator::featureIndex(WHITE, __builtin_ctzll(rest));
+        }
+        
+        for (int i = 0; i < NN_HIDDEN1; i++) sum1[i] = params[B1 + i];
+        for (int f = 0; f < featureCount; f++) {
+            const float* column = &params[W1 + features[f] * NN_HIDDEN1];
+            for (int i = 0; i < NN_HIDDEN1; i++) sum1[i] += column[i];
+        }
+        for (int i = 0; i < NN_HIDDEN1; i++) hidden1[i] = clip(sum1[i]);
+        
+        float output = params[B3];
+        for (int j = 0; j < NN_HIDDEN2; j++) {
+            const float* row = &params[W2 + j * NN_HIDDEN1];
+            float sum = params[B2 + j];
+            for (int i = 0; i < NN_HIDDEN1; i++) sum += row[i] * hidden1[i];
+            sum2[j] = sum;
+            hidden2[j] = clip(sum);
+            output += params[W3 + j] * hidden2[j];
+        }
+        return output;
+    }
+    
+    // Accumulate the gradient of the squared error of the last forward pass
+    void backward(float outputError) {
+        float error2[NN_HIDDEN2];
+        gradient[B3] += outputError;
+        for (int j = 0; j < NN_HIDDEN2; j++) {
+            gradient[W3 + j] += outputError * hidden2[j];
+            error2[j] = (sum2[j] > 0.0f && sum2[j] < 1.0f) ? outputError * params[W3 + j] : 0.0f;
+        }
+        
+        float error1[NN_HIDDEN1] = {};
+        for (int j = 0; j < NN_HIDDEN2; j++) {
+            if (error2[j] == 0.0f) continue;
+            const float* row = &params[W2 + j * NN_HIDDEN1];
+            float* rowGradient = &gradient[W2 + j * NN_HIDDEN1];
+            for (int i = 0; i < NN_HIDDEN1; i++) {
+                rowGradient[i] += error2[j] * hidden1[i];
+                error1[i] += error2[j] * row[i];
+            }
+            gradient[B2 + j] += error2[j];
+        }
+        
+        for (int i = 0; i < NN_HIDDEN1; i++) {
+            if (sum1[i] <= 0.0f || sum1[i] >= 1.0f) error1[i] = 0.0f;
+            gradient[B1 + i] += error1[i];
+        }
+        for (int f = 0; f < featureCount; f++) {
+            float* column = &gradient[W1 + features[f] * NN_HIDDEN1];
+            for (int i = 0; i < NN_HIDDEN1; i++) column[i] += error1[i];
+        }
+    }
+    
+    // Adam step on the accumulated gradient, then clip to the quantizable ranges
+    void step(int batch) {
+        steps++;
+        float correction1 = 1.0f - std::pow(ADAM_BETA1, static_cast<float>(steps));
+        float correction2 = 1.0f - std::pow(ADAM_BETA2, static_cast<float>(steps));
+        for (int i = 0; i < PARAMETERS; i++) {
+            float g = gradient[i] / batch;
+            gradient[i] = 0.0f;
+            if (g == 0.0f && moment1[i] == 0.0f) continue;
+            moment1[i] = ADAM_BETA1 * moment1[i] + (1.0f - ADAM_BETA1) * g;
+            moment2[i] = ADAM_BETA2 * moment2[i] + (1.0f - ADAM_BETA2) * g * g;
+            params[i] -= LEARNING_RATE * (moment1[i] / correction1) / (std::sqrt(moment2[i] / correction2) + ADAM_EPSILON);
+        }
+        for (int i = W1; i < B1; i++) params[i] = std::max(-INPUT_WEIGHT_LIMIT, std::min(INPUT_WEIGHT_LIMIT, params[i]));
+        for (int i = W2; i < B2; i++) params[i] = std::max(-INT8_WEIGHT_LIMIT, std::min(INT8_WEIGHT_LIMIT, params[i]));
+        for (int i = W3; i < B3; i++) params[i] = std::max(-INT8_WEIGHT_LIMIT, std::min(INT8_WEIGHT_LIMIT, params[i]));
+    }
+    
+    void quantize(NNWeights& network) const {
+        auto fixed = [](float value, float scale, long limit) {
+            return std::max(-limit, std::min(limit, std::lround(value * scale)));
+        };
+        const float activationOne = static_cast<float>(NN_ACTIVATION_ONE);
+        const float weightOne = static_cast<float>(NN_WEIGHT_ONE);
+        const float outputOne = activationOne * weightOne;
+        
+        for (int f = 0; f < NN_INPUTS; f++) {
+            for (int i = 0; i < NN_HIDDEN1; i++) {
+                network.inputWeights[f][i] = static_cast<int16_t>(fixed(params[W1 + f * NN_HIDDEN1 + i], activationOne, 32767));
+            }
+        }
+        for (int i = 0; i < NN_HIDDEN1; i++) {
+            network.inputBias[i] = static_cast<int16_t>(fixed(params[B1 + i], activationOne, 32767));
+        }
+        for (int j = 0; j < NN_HIDDEN2; j++) {
+            for (int i = 0; i < NN_HIDDEN1; i++) {
+                network.hiddenWeights[j][i] = static_cast<int8_t>(fixed(params[W2 + j * NN_HIDDEN1 + i], weightOne, 127));
+            }
+            network.hiddenBias[j] = static_cast<int32_t>(fixed(params[B2 + j], outputOne, 1L << 30));
+            network.outputWeights[j] = static_cast<int8_t>(fixed(params[W3 + j], weightOne, 127));
+        }
+        network.outputBias = static_cast<int32_t>(fixed(params[B3], outputOne, 1L << 30));
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int positionCount = 20000;
+    int depth = 4;
+    int epochs = 20;
+    unsigned int seed = 1;
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const char* outPath = "evaluator.rvnn";
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--positions" && hasValue) positionCount = std::atoi(argv[++i]);
+        else if (arg == "--depth" && hasValue) depth = std::atoi(argv[++i]);
+        else if (arg == "--epochs" && hasValue) epochs = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) threads = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (positionCount < HOLDOUT_EVERY || depth < 1 || epochs < 1 || threads < 1) {
+        usage();
+        return 2;
+    }
+    
+    std::vector<int> boards;
+    std::vector<int> players;
+    generatePositions(positionCount, seed, boards, players);
+    std::vector<int> labels = labelPositions(boards, players, depth, threads);
+    
+    std::vector<Sample> training;
+    std::vector<Sample> holdout;
+    for (size_t i = 0; i < players.size(); i++) {
+        uint64_t black;
+        uint64_t white;
+        Bitboard<NN_BOARD_SIZE>::fromBoard(&boards[i * SQUARES], BLACK, &black, &white);
+        float target = static_cast<float>(labels[i]) / NN_EVAL_SCALE;
+        if (i % HOLDOUT_EVERY == 0) {
+            holdout.push_back({black, white, target});
+            continue;
+        }
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            training.push_back({transformDiscs(black, symmetry), transformDiscs(white, symmetry), target});
+        }
+    }
+    
+    Trainer trainer(seed);
+    std::mt19937 rng(seed);
+    for (int epoch = 1; epoch <= epochs; epoch++) {
+        std::shuffle(training.begin(), training.end(), rng);
+        double trainError = 0.0;
+        for (size_t start = 0; start < training.size(); start += BATCH_SIZE) {
+            size_t end = std::min(training.size(), start + BATCH_SIZE);
+            for (size_t i = start; i < end; i++) {
+                float error = trainer.forward(training[i].black, training[i].white) - training[i].target;
+                trainError += error * error;
+                trainer.backward(error);
+            }
+            trainer.step(static_cast<int>(end - start));
+        }
+        
+        double holdoutError = 0.0;
+        for (const Sample& sample : holdout) {
+            float error = trainer.forward(sample.black, sample.white) - sample.target;
+            holdoutError += error * error;
+        }
+        std::printf("epoch %2d  train rms %.1f  holdout rms %.1f\n", epoch,
+                    std::sqrt(trainError / training.size()) * NN_EVAL_SCALE,
+                    std::sqrt(holdoutError / holdout.size()) * NN_EVAL_SCALE);
+        std::fflush(stdout);
+    }
+    
+    NNWeights network;
+    trainer.quantize(network);
+    if (!NeuralEvaluator::save(outPath, network)) {
+        std::fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+    }
+    
+    // Check the file as the engine will use it
+    NeuralEvaluator evaluator;
+    if (!evaluator.load(outPath)) {
+        std::fprintf(stderr, "cannot reload %s\n", outPath);
+        return 1;
+    }
+    double quantizedError = 0.0;
+    double labelSpread = 0.0;
+    for (const Sample& sample : holdout) {
+        NNAccumulator accumulator;
+        evaluator.refresh(accumulator, sample.black, sample.white);
+        double error = evaluator.evaluate(accumulator) - sample.target * NN_EVAL_SCALE;
+        quantizedError += error * error;
+        labelSpread += sample.target * NN_EVAL_SCALE * sample.target * NN_EVAL_SCALE;
+    }
+    std::printf("wrote %s (%s kernels): quantized holdout rms %.1f points (labels rms %.1f)\n", outPath,
+                evaluator.kernelName(), std::sqrt(quantizedError / holdout.size()),
+                std::sqrt(labelSpread / holdout.size()));
+    return 0;
+}
@@ -0,0 +1,204 @@
+// Fixed-depth search benchmark: nodes/sec and, on Linux, hardware branch statistics.
+//
+// Searches a reproducible set of positions (random playouts from the start) to a
+// fixed depth and reports throughput. Branch and branch-miss counts come from
+// perf_event_open where the kernel allows user-space counting. --weights searches with
+// an evaluation network; --check-features verifies the incrementally updated evaluation
+// features against a full recomputation at every node (and fails on any difference).
+// --trace writes a timeline of the searches as Chrome trace JSON (needs a build with
+// -DREVERSI_TRACE=ON).
+//
+// Usage:
+//   search-bench [--positions N] [--depth D] [--seed S] [--selective] [--weights FILE] [--check-features]
+//                [--trace FILE]
+
+#include "AI.h"
+#include "GameEngine.h"
+#include "NeuralEval.h"
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Position {
+    int board[8][8];
+    int player;
+};
+
+enum class CounterKind {
+    BRANCHES,
+    BRANCH_MISSES
+};
+
+// Hardware counter for the calling thread (no-op where unsupported)
+class PerfCounter {
+private:
+    int fd = -1;
+
+public:
+    explicit PerfCounter(CounterKind kind) {
+#ifdef __linux__
+        uint64_t config = (kind == CounterKind::BRANCHES) ? PERF_COUNT_HW_BRANCH_INSTRUCTIONS
+                                                          : PERF_COUNT_HW_BRANCH_MISSES;
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)kind;
+#endif
+    }
+    
+    ~PerfCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+    
+    bool available() const { return fd >= 0; }
+    
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    
+    uint64_t stop() {
+        uint64_t value = 0;
+#ifdef __linux__
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) value = 0;
+#endif
+        return value;
+    }
+};
+
+// Positions reached by random playouts of 10 to 40 moves
+std::vector<Position> generatePositions(int count, unsigned int seed) {
+    std::vector<Position> positions;
+    std::mt19937 rng(seed);
+    GameEngine engine;
+    
+    while (static_cast<int>(positions.size()) < count) {
+        engine.initGame();
+        int plies = 10 + static_cast<int>(rng() % 31);
+        bool ok = true;
+        for (int ply = 0; ply < plies && ok; ply++) {
+            int player = engine.getCurrentPlayer();
+            auto moves = engine.getValidMoves(player);
+            if (moves.empty()) {
+                ok = !engine.isGameOver();
+                if (ok) engine.passTurn();
+                continue;
+            }
+            auto move = moves[rng() % moves.size()];
+            engine.makeMove(move.first, move.second, player);
+        }
+        if (!ok || engine.getValidMoves(engine.getCurrentPlayer()).empty()) continue;
+        
+        Position position;
+        engine.getBoardState(&position.board[0][0]);
+        position.player = engine.getCurrentPlayer();
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int count = 200;
+    int depth = 6;
+    unsigned int seed = 1;
+    bool selective = false;
+    bool checkFeatures = false;
+    const char* weightsPath = nullptr;
+    const char* tracePath = nullptr;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--positions" && i + 1 < argc) count = std::atoi(argv[++i]);
+        else if (arg == "--depth" && i + 1 < argc) depth = std::atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (arg == "--selective") selective = true;
+        else if (arg == "--weights" && i + 1 < argc) weightsPath = argv[++i];
+        else if (arg == "--check-features") checkFeatures = true;
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: search-bench [--positions N] [--depth D] [--seed S] [--selective] "
+                                 "[--weights FILE] [--check-features] [--trace FILE]\n");
+            return 2;
+        }
+    }
+    
+    NeuralEvaluator evaluator;
+    if (weightsPath != nullptr && !evaluator.load(weightsPath)) {
+        std::fprintf(stderr, "cannot load %s\n", weightsPath);
+        return 1;
+    }
+    
+    auto positions = generatePositions(count, seed);
+    
+    GameEngine engine;
+    AI ai(&engine);
+    ai.setNeuralEvaluator(weightsPath != nullptr ? &evaluator : nullptr);
+    ai.setFeatureCheck(checkFeatures);
+    PerfCounter branches(CounterKind::BRANCHES);
+    PerfCounter misses(CounterKind::BRANCH_MISSES);
+    
+    uint64_t nodes = 0;
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    branches.start();
+    misses.start();
+    for (auto& position : positions) {
+        ai.clearCache();
+        checksum += ai.searchPosition(position.board, position.player, depth, selective);
+        nodes += ai.getNodeCount();
+    }
+    uint64_t missCount = misses.stop();
+    uint64_t branchCount = branches.stop();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::printf("positions %d  depth %d  %s%s\n", count, depth, selective ? "selective" : "full-width",
+                weightsPath != nullptr ? "  network" : "");
+    std::printf("nodes %llu  time %.3f s  %.0f nodes/s  (score checksum %lld)\n",
+                static_cast<unsigned long long>(nodes), seconds, nodes / seconds, checksum);
+    if (branches.available() && misses.available() && branchCount > 0) {
+        std::printf("branches/node %.1f  misses/node %.2f  miss rate %.2f%%\n",
+                    static_cast<double>(branchCount) / nodes, static_cast<double>(missCount) / nodes,
+                    100.0 * missCount / branchCount);
+    } else {
+        std::printf("branch counters unavailable\n");
+    }
+    if (checkFeatures) {
+        std::printf("feature mismatches %llu\n", static_cast<unsigned long long>(ai.getFeatureMismatchCount()));
+        if (ai.getFeatureMismatchCount() > 0) return 1;
+    }
+    if (tracePath != nullptr && !writeTraceJson(tracePath)) {
+        std::fprintf(stderr, "cannot write trace %s (tracing needs a build with -DREVERSI_TRACE=ON)\n", tracePath);
+        return 1;
+    }
+    return 0;
+}
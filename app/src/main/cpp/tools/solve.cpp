@@ -0,0 +1,132 @@
+// Exact solver for the 6x6 and 8x8 variants.
+//
+// Plays an optional move sequence from the starting position and searches the
+// result to the end of the game with perfect play. Solves take seconds at 22-24 empties
+// (6x6 positions after 8-10 moves) and grow about tenfold every two plies more, so use a
+// move sequence that reaches the endgame on either size. With --store, positions solved in
+// earlier runs are looked up instead of searched and new solves are added (see SolvedStore.h).
+//
+// Usage:
+//   solve [--size 6|8] [--moves SEQUENCE] [--store FILE]
+//
+// Moves are a column letter followed by a row number, e.g. "c4e3f6" (rows from 1).
+
+#include "GameEngine.h"
+#include "SolvedStore.h"
+#include "Solver.h"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+// Apply a move sequence, passing automatically when the side to move has no moves
+template <int N>
+bool playMoves(BasicGameEngine<N>& engine, const std::string& moves) {
+    size_t i = 0;
+    while (i < moves.size()) {
+        int col = std::tolower(static_cast<unsigned char>(moves[i++])) - 'a';
+        int row = 0;
+        while (i < moves.size() && std::isdigit(static_cast<unsigned char>(moves[i]))) {
+            row = row * 10 + (moves[i++] - '0');
+        }
+        row -= 1;
+        
+        int player = engine.getCurrentPlayer();
+        if (!engine.playerCanMove(player)) {
+            engine.passTurn();
+            player = engine.getCurrentPlayer();
+        }
+        if (col < 0 || col >= N || row < 0 || row >= N || !engine.makeMove(row, col, player)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+int run(const std::string& moves, const char* storePath) {
+    BasicGameEngine<N> engine;
+    if (!playMoves(engine, moves)) {
+        std::fprintf(stderr, "illegal move sequence: %s\n", moves.c_str());
+        return 1;
+    }
+    
+    int board[N][N];
+    engine.getBoardState(&board[0][0]);
+    int player = engine.getCurrentPlayer();
+    
+    int empties = 0;
+    for (int i = 0; i < N; i++) {
+        std::printf("%2d ", i + 1);
+        for (int j = 0; j < N; j++) {
+            std::printf(" %c", board[i][j] == BLACK ? 'X' : board[i][j] == WHITE ? 'O' : '.');
+            if (board[i][j] == EMPTY) empties++;
+        }
+        std::printf("\n");
+    }
+    std::printf("   ");
+    for (int j = 0; j < N; j++) {
+        std::printf(" %c", 'a' + j);
+    }
+    std::printf("\n%dx%d, %d empties, %s to move\n", N, N, empties, player == BLACK ? "Black" : "White");
+    
+    BasicSolver<N> solver;
+    BasicSolvedStore<N> store;
+    if (storePath != nullptr) {
+        if (!store.open(storePath)) {
+            std::fprintf(stderr, "cannot open solved-position store %s\n", storePath);
+            return 1;
+        }
+        solver.setStore(&store);
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    int margin = solver.solve(&board[0][0], player);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    int blackMargin = (player == BLACK) ? margin : -margin;
+    const char* result = (blackMargin > 0) ? "Black wins" : (blackMargin < 0) ? "White wins" : "Draw";
+    std::printf("Perfect play: %s by %d discs (Black %+d)\n", result, std::abs(blackMargin), blackMargin);
+    int best = solver.getBestMove();
+    if (best >= 0) {
+        std::printf("Best move: %c%d\n", 'a' + best % N, best / N + 1);
+    }
+    std::printf("%llu nodes, %.2f s, %.0f nodes/s\n", static_cast<unsigned long long>(solver.getNodeCount()),
+                seconds, solver.getNodeCount() / seconds);
+    if (storePath != nullptr) {
+        std::printf("Store: %zu positions, %llu hits, %llu misses\n", store.getRecordCount(),
+                    static_cast<unsigned long long>(store.getHitCount()),
+                    static_cast<unsigned long long>(store.getMissCount()));
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int size = 6;
+    std::string moves;
+    const char* storePath = nullptr;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) size = std::atoi(argv[++i]);
+        else if (arg == "--moves" && i + 1 < argc) moves = argv[++i];
+        else if (arg == "--store" && i + 1 < argc) storePath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: solve [--size 6|8] [--moves SEQUENCE] [--store FILE]\n");
+            return 2;
+        }
+    }
+    
+    switch (size) {
+        case 6: return run<6>(moves, storePath);
+        case 8: return run<8>(moves, storePath);
+        default:
+            std::fprintf(stderr, "unsupported board size %d (6 or 8)\n", size);
+            return 2;
+    }
+}
@@ -0,0 +1,64 @@
+// Maintenance of a solved-position store (see SolvedStore.h).
+//
+// Prints how many positions the file holds and how many of its records are stale
+// (duplicates appended by concurrent engine processes, or damaged records), and with
+// --compact rewrites it without them. Do not compact while engines append to the file.
+//
+// Usage:
+//   solved-store [--size 6|8] [--compact] FILE
+
+#include "SolvedStore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+template <int N>
+int run(const char* path, bool compact) {
+    BasicSolvedStore<N> store;
+    if (!store.open(path)) {
+        std::fprintf(stderr, "cannot open %s as a %dx%d store\n", path, N, N);
+        return 1;
+    }
+    std::printf("%s: %zu positions, %zu stale records\n", path, store.getRecordCount(), store.getStaleCount());
+    
+    if (compact) {
+        if (!store.compact()) {
+            std::fprintf(stderr, "compaction failed\n");
+            return 1;
+        }
+        std::printf("compacted: %zu positions, %zu stale records\n", store.getRecordCount(), store.getStaleCount());
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int size = 8;
+    bool compact = false;
+    const char* path = nullptr;
+    
+    bool valid = true;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) size = std::atoi(argv[++i]);
+        else if (arg == "--compact") compact = true;
+        else if (path == nullptr && !arg.empty() && arg[0] != '-') path = argv[i];
+        else valid = false;
+    }
+    if (!valid || path == nullptr) {
+        std::fprintf(stderr, "usage: solved-store [--size 6|8] [--compact] FILE\n");
+        return 2;
+    }
+    
+    switch (size) {
+        case 6: return run<6>(path, compact);
+        case 8: return run<8>(path, compact);
+        default:
+            std::fprintf(stderr, "unsupported board size %d (6 or 8)\n", size);
+            return 2;
+    }
+}
@@ -0,0 +1,483 @@
+// Engine-vs-engine tournament for strength and latency regression testing.
+//
+// Two engine configurations play every opening of a balanced opening set twice,
+// with colours swapped, in parallel on all cores. Reports the Elo difference of A
+// against B with a 95% confidence interval, optional SPRT early stopping and the
+// per-move latency distribution of each engine. With --trace, the timeline of the last
+// games on each thread is written as Chrome trace JSON (needs a -DREVERSI_TRACE=ON build).
+//
+// Usage:
+//   tournament --a SPEC --b SPEC [--games N] [--threads T] [--seed S]
+//              [--plies P] [--balance SCORE] [--openings FILE]
+//              [--sprt ELO0,ELO1] [--alpha A] [--beta B] [--trace FILE]
+//
+// Engine SPEC: <easy|medium|hard|expert|mcts>[:budget=MS][:mpc=on|off][:confidence=X][:threads=T][:nn=FILE]
+// Opening files hold one move sequence per line, e.g. "f5d6c3d3c4".
+
+#include "AI.h"
+#include "GameEngine.h"
+#include "NeuralEval.h"
+#include "Solver.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct EngineConfig {
+    std::string spec;
+    AIDifficulty difficulty = AIDifficulty::EXPERT;
+    int budgetMs = 100;
+    bool probCut = true;
+    double confidence = 1.5;
+    int threads = 1;
+    std::shared_ptr<NeuralEvaluator> network;   // shared read-only by all games
+};
+
+using Move = std::pair<int, int>;
+using Opening = std::vector<Move>;
+
+// Per-engine move statistics
+struct MoveStats {
+    std::vector<double> latenciesMs;
+    uint64_t depthSum = 0;
+};
+
+// Tournament totals from engine A's point of view
+struct Totals {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    int errors = 0;
+    
+    int games() const { return wins + draws + losses; }
+};
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: tournament --a SPEC --b SPEC [--games N] [--threads T] [--seed S]\n"
+                 "                  [--plies P] [--balance SCORE] [--openings FILE]\n"
+                 "                  [--sprt ELO0,ELO1] [--alpha A] [--beta B] [--trace FILE]\n"
+                 "SPEC: <easy|medium|hard|expert|mcts>[:budget=MS][:mpc=on|off][:confidence=X][:threads=T][:nn=FILE]\n");
+}
+
+bool parseEngineConfig(const std::string& spec, EngineConfig* config) {
+    config->spec = spec;
+    std::stringstream stream(spec);
+    std::string part;
+    bool first = true;
+    
+    while (std::getline(stream, part, ':')) {
+        if (first) {
+            first = false;
+            if (part == "easy") config->difficulty = AIDifficulty::EASY;
+            else if (part == "medium") config->difficulty = AIDifficulty::MEDIUM;
+            else if (part == "hard") config->difficulty = AIDifficulty::HARD;
+            else if (part == "expert") config->difficulty = AIDifficulty::EXPERT;
+            else if (part == "mcts") config->difficulty = AIDifficulty::MCTS;
+            else return false;
+            continue;
+        }
+        
+        size_t eq = part.find('=');
+        if (eq == std::string::npos) return false;
+        std::string key = part.substr(0, eq);
+        std::string value = part.substr(eq + 1);
+        
+        if (key == "budget") config->budgetMs = std::atoi(value.c_str());
+        else if (key == "mpc") config->probCut = (value == "on");
+        else if (key == "confidence") config->confidence = std::atof(value.c_str());
+        else if (key == "threads") config->threads = std::atoi(value.c_str());
+        else if (key == "nn") {
+            config->network = std::make_shared<NeuralEvaluator>();
+            if (!config->network->load(value.c_str())) return false;
+        }
+        else return false;
+    }
+    return !first && config->budgetMs > 0 && config->confidence > 0.0 && config->threads > 0;
+}
+
+void applyConfig(AI& ai, const EngineConfig& config) {
+    ai.setDifficulty(config.difficulty);
+    ai.setTimeBudget(config.budgetMs);
+    ai.setProbCutEnabled(config.probCut);
+    ai.setProbCutConfidence(config.confidence);
+    ai.setThreadCount(config.threads);
+    ai.setNeuralEvaluator(config.network.get());
+    ai.setSolverTableBits(SOLVER_TABLE_BITS);
+}
+
+bool parseMoves(const std::string& text, Opening* opening) {
+    opening->clear();
+    for (size_t i = 0; i + 1 < text.size(); i += 2) {
+        char file = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+        char rank = text[i + 1];
+        if (file < 'a' || file > 'h' || rank < '1' || rank > '8') return false;
+        opening->push_back({rank - '1', file - 'a'});
+    }
+    return !opening->empty();
+}
+
+// Play an opening on a fresh game; returns false if any move is illegal
+bool playOpening(GameEngine& engine, const Opening& opening) {
+    engine.initGame();
+    for (const auto& move : opening) {
+        if (!engine.makeMove(move.first, move.second, engine.getCurrentPlayer())) return false;
+    }
+    return true;
+}
+
+// Board key invariant under the 8 symmetries of the square
+std::string canonicalKey(GameEngine& engine) {
+    int board[64];
+    engine.getBoardState(board);
+    
+    std::string best;
+    for (int symmetry = 0; symmetry < 8; symmetry++) {
+        std::string key(65, ' ');
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) {
+                int r = row, c = col;
+                if (symmetry & 1) c = 7 - c;
+                if (symmetry & 2) r = 7 - r;
+                if (symmetry & 4) std::swap(r, c);
+                key[row * 8 + col] = static_cast<char>('0' + board[r * 8 + c]);
+            }
+        }
+        key[64] = static_cast<char>('0' + engine.getCurrentPlayer());
+        if (best.empty() || key < best) best = key;
+    }
+    return best;
+}
+
+// All distinct positions `plies` moves deep whose shallow search score is within `balance`
+std::vector<Opening> generateOpenings(int plies, int balance) {
+    std::vector<Opening> frontier(1);
+    GameEngine engine;
+    
+    for (int ply = 0; ply < plies; ply++) {
+        std::vector<Opening> next;
+        std::set<std::string> seen;
+        for (const auto& opening : frontier) {
+            playOpening(engine, opening);
+            for (const auto& move : engine.getValidMoves(engine.getCurrentPlayer())) {
+                Opening extended = opening;
+                extended.push_back(move);
+                playOpening(engine, extended);
+                if (seen.insert(canonicalKey(engine)).second) {
+                    next.push_back(extended);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    
+    // Keep only roughly even positions so neither colour is favoured
+    std::vector<Opening> balanced;
+    AI judge(&engine);
+    for (const auto& opening : frontier) {
+        playOpening(engine, opening);
+        int board[8][8];
+        engine.getBoardState(&board[0][0]);
+        int score = judge.searchPosition(board, BLACK, 4, false);
+        if (std::abs(score) <= balance) {
+            balanced.push_back(opening);
+        }
+    }
+    return balanced;
+}
+
+bool readOpenings(const char* path, std::vector<Opening>& openings) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return false;
+    
+    char line[512];
+    GameEngine engine;
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        std::string text(line);
+        text.erase(std::remove_if(text.begin(), text.end(), ::isspace), text.end());
+        if (text.empty() || text[0] == '#') continue;
+        
+        Opening opening;
+        if (parseMoves(text, &opening) && playOpening(engine, opening)) {
+            openings.push_back(opening);
+        } else {
+            std::fprintf(stderr, "skipping invalid opening: %s\n", text.c_str());
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+double logistic(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double eloFromScore(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Per-game score variance of the trinomial (win/draw/loss) result
+double scoreVariance(const Totals& totals, double score) {
+    double n = totals.games();
+    return (totals.wins * (1.0 - score) * (1.0 - score) +
+            totals.draws * (0.5 - score) * (0.5 - score) +
+            totals.losses * score * score) / n;
+}
+
+// Normal approximation of the SPRT log-likelihood ratio for H1 (elo1) against H0 (elo0)
+double sprtLLR(const Totals& totals, double elo0, double elo1) {
+    if (totals.games() == 0) return 0.0;
+    double n = totals.games();
+    double score = (totals.wins + 0.5 * totals.draws) / n;
+    double variance = scoreVariance(totals, score);
+    if (variance <= 0.0) return 0.0;
+    
+    double s0 = logistic(elo0);
+    double s1 = logistic(elo1);
+    return n * (s1 - s0) * (2.0 * score - s0 - s1) / (2.0 * variance);
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void printLatency(const char* name, MoveStats& stats) {
+    auto& values = stats.latenciesMs;
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    double mean = values.empty() ? 0.0 : sum / values.size();
+    double depth = values.empty() ? 0.0 : static_cast<double>(stats.depthSum) / values.size();
+    
+    std::printf("%-3s %7zu %8.2f %8.2f %8.2f %8.2f %8.2f %7.2f\n", name, values.size(), mean,
+                percentile(values, 0.5), percentile(values, 0.9), percentile(values, 0.99),
+                values.empty() ? 0.0 : values.back(), depth);
+}
+
+// Play one game; returns Black's result (1 = win, 0.5 = draw, 0 = loss) or -1 on an illegal move
+double playGame(GameEngine& engine, const Opening& opening, AI& black, AI& white,
+                MoveStats& blackStats, MoveStats& whiteStats) {
+    playOpening(engine, opening);
+    black.clearCache();
+    white.clearCache();
+    
+    while (!engine.isGameOver()) {
+        int player = engine.getCurrentPlayer();
+        if (!engine.playerCanMove(player)) {
+            engine.passTurn();
+            continue;
+        }
+        
+        AI& ai = (player == BLACK) ? black : white;
+        MoveStats& stats = (player == BLACK) ? blackStats : whiteStats;
+        
+        auto start = std::chrono::steady_clock::now();
+        auto move = ai.getBestMove();
+        auto end = std::chrono::steady_clock::now();
+        stats.latenciesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        stats.depthSum += ai.getLastSearchDepth();
+        
+        if (!engine.makeMove(move.first, move.second, player)) return -1.0;
+    }
+    
+    int blackScore, whiteScore;
+    engine.getScores(&blackScore, &whiteScore);
+    if (blackScore > whiteScore) return 1.0;
+    if (blackScore < whiteScore) return 0.0;
+    return 0.5;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    EngineConfig configA, configB;
+    bool haveA = false, haveB = false;
+    int maxGames = 1000;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    unsigned int seed = 1;
+    int plies = 6;
+    int balance = 20;
+    const char* openingsPath = nullptr;
+    const char* tracePath = nullptr;
+    bool useSprt = false;
+    double elo0 = 0.0, elo1 = 5.0, alpha = 0.05, beta = 0.05;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--a" && hasValue) haveA = parseEngineConfig(argv[++i], &configA);
+        else if (arg == "--b" && hasValue) haveB = parseEngineConfig(argv[++i], &configB);
+        else if (arg == "--games" && hasValue) maxGames = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) threads = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (arg == "--plies" && hasValue) plies = std::atoi(argv[++i]);
+        else if (arg == "--balance" && hasValue) balance = std::atoi(argv[++i]);
+        else if (arg == "--openings" && hasValue) openingsPath = argv[++i];
+        else if (arg == "--trace" && hasValue) tracePath = argv[++i];
+        else if (arg == "--sprt" && hasValue) {
+            useSprt = std::sscanf(argv[++i], "%lf,%lf", &elo0, &elo1) == 2;
+            if (!useSprt) {
+                usage();
+                return 2;
+            }
+        }
+        else if (arg == "--alpha" && hasValue) alpha = std::atof(argv[++i]);
+        else if (arg == "--beta" && hasValue) beta = std::atof(argv[++i]);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    
+    if (!haveA || !haveB || maxGames < 2) {
+        usage();
+        return 2;
+    }
+    if (threads < 1) threads = 1;
+    
+    std::vector<Opening> openings;
+    if (openingsPath != nullptr) {
+        if (!readOpenings(openingsPath, openings)) {
+            std::fprintf(stderr, "cannot read %s\n", openingsPath);
+            return 1;
+        }
+    } else {
+        openings = generateOpenings(plies, balance);
+    }
+    if (openings.empty()) {
+        std::fprintf(stderr, "no openings\n");
+        return 1;
+    }
+    std::shuffle(openings.begin(), openings.end(), std::mt19937(seed));
+    
+    int pairs = maxGames / 2;
+    std::printf("A: %s\nB: %s\n%zu openings, %d games, %d threads\n",
+                configA.spec.c_str(), configB.spec.c_str(), openings.size(), pairs * 2, threads);
+    
+    double lowerBound = std::log(beta / (1.0 - alpha));
+    double upperBound = std::log((1.0 - beta) / alpha);
+    
+    std::atomic<int> nextPair(0);
+    std::atomic<bool> stop(false);
+    std::mutex resultsMutex;
+    Totals totals;
+    MoveStats statsA, statsB;
+    const char* verdict = "not run";
+    
+    auto worker = [&]() {
+        TRACE_THREAD_NAME("game worker");
+        GameEngine engine;
+        AI aiA(&engine), aiB(&engine);
+        applyConfig(aiA, configA);
+        applyConfig(aiB, configB);
+        MoveStats localA, localB;
+        
+        while (!stop.load()) {
+            int pair = nextPair.fetch_add(1);
+            if (pair >= pairs) break;
+            const Opening& opening = openings[pair % openings.size()];
+            
+            // Same opening twice with colours swapped
+            for (int game = 0; game < 2 && !stop.load(); game++) {
+                TRACE_SCOPE_ARG("tournament.game", "game", pair * 2 + game);
+                aiA.setSeed(seed + pair * 2 + game);
+                aiB.setSeed(seed + pair * 2 + game + 0x9E3779B9u);
+                
+                bool aIsBlack = (game == 0);
+                double blackResult = aIsBlack
+                    ? playGame(engine, opening, aiA, aiB, localA, localB)
+                    : playGame(engine, opening, aiB, aiA, localB, localA);
+                
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                if (blackResult < 0.0) {
+                    totals.errors++;
+                    continue;
+                }
+                double resultA = aIsBlack ? blackResult : 1.0 - blackResult;
+                if (resultA == 1.0) totals.wins++;
+                else if (resultA == 0.0) totals.losses++;
+                else totals.draws++;
+                
+                if (useSprt) {
+                    double llr = sprtLLR(totals, elo0, elo1);
+                    if (llr >= upperBound) {
+                        verdict = "H1 accepted";
+                        stop.store(true);
+                    } else if (llr <= lowerBound) {
+                        verdict = "H0 accepted";
+                        stop.store(true);
+                    }
+                }
+                
+                std::fprintf(stderr, "\r%d games: +%d =%d -%d", totals.games(), totals.wins, totals.draws, totals.losses);
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        statsA.latenciesMs.insert(statsA.latenciesMs.end(), localA.latenciesMs.begin(), localA.latenciesMs.end());
+        statsB.latenciesMs.insert(statsB.latenciesMs.end(), localB.latenciesMs.begin(), localB.latenciesMs.end());
+        statsA.depthSum += localA.depthSum;
+        statsB.depthSum += localB.depthSum;
+    };
+    
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    std::fprintf(stderr, "\n");
+    
+    int games = totals.games();
+    if (games == 0) {
+        std::fprintf(stderr, "no games completed (%d illegal-move errors)\n", totals.errors);
+        return 1;
+    }
+    
+    double score = (totals.wins + 0.5 * totals.draws) / games;
+    double stderrScore = std::sqrt(scoreVariance(totals, score) / games);
+    double elo = eloFromScore(score);
+    double eloLow = eloFromScore(score - 1.96 * stderrScore);
+    double eloHigh = eloFromScore(score + 1.96 * stderrScore);
+    
+    std::printf("\nGames: %d  A: +%d =%d -%d  score %.1f%%", games, totals.wins, totals.draws,
+                totals.losses, score * 100.0);
+    if (totals.errors > 0) std::printf("  (%d illegal-move errors)", totals.errors);
+    std::printf("\nElo A-B: %+.1f  95%% CI [%+.1f, %+.1f]  (+/- %.1f)\n", elo, eloLow, eloHigh,
+                (eloHigh - eloLow) / 2.0);
+    
+    if (useSprt) {
+        if (!stop.load()) verdict = "inconclusive";
+        std::printf("SPRT [%.1f, %.1f] alpha %.2f beta %.2f: LLR %.2f (%.2f, %.2f) %s\n", elo0, elo1,
+                    alpha, beta, sprtLLR(totals, elo0, elo1), lowerBound, upperBound, verdict);
+    }
+    
+    std::printf("\nMove latency (ms)\n");
+    std::printf("%-3s %7s %8s %8s %8s %8s %8s %7s\n", "", "moves", "mean", "p50", "p90", "p99", "max", "depth");
+    printLatency("A", statsA);
+    printLatency("B", statsB);
+    
+    if (tracePath != nullptr && !writeTraceJson(tracePath)) {
+        std::fprintf(stderr, "cannot write trace %s (tracing needs a build with -DREVERSI_TRACE=ON)\n", tracePath);
+        return 1;
+    }
+    return 0;
+}
@@ -19,6 +19,7 @@ class GameSetupDialog(context: Context, private val onGameStart: (gameMode: Int,
     private lateinit var radioMedium: RadioButton
     private lateinit var radioHard: RadioButton
     private lateinit var radioExpert: RadioButton
+    private lateinit var radioMcts: RadioButton
     private lateinit var btnStart: Button
     private lateinit var btnCancel: Button
     
@@ -38,6 +39,7 @@ class GameSetupDialog(context: Context, private val onGameStart: (gameMode: Int,
         radioMedium = findViewById(R.id.radioMedium)
         radioHard = findViewById(R.id.radioHard)
         radioExpert = findViewById(R.id.radioExpert)
+        radioMcts = findViewById(R.id.radioMcts)
         btnStart = findViewById(R.id.btnStart)
         btnCancel = findViewById(R.id.btnCancel)
         
@@ -67,6 +69,7 @@ class GameSetupDialog(context: Context, private val onGameStart: (gameMode: Int,
                 R.id.radioMedium -> AIDifficulty.MEDIUM
                 R.id.radioHard -> AIDifficulty.HARD
                 R.id.radioExpert -> AIDifficulty.EXPERT
+                R.id.radioMcts -> AIDifficulty.MCTS
                 else -> AIDifficulty.MEDIUM
             }
         }
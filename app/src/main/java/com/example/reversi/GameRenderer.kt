@@ -28,12 +28,9 @@ class GameRenderer : GLSurfaceView.Renderer {
     private val COLOR_HIGHLIGHT_WHITE = floatArrayOf(1.0f, 0.5f, 0.0f, 0.8f)  // White moves - neon orange
     private val COLOR_LAST_MOVE = floatArrayOf(1.0f, 0.0f, 0.0f, 0.7f)  // Red for last move
     
-    // Game state
-    private var boardState = IntArray(64) { 0 }
-    private var validMovesBlack = mutableSetOf<Int>()
-    private var validMovesWhite = mutableSetOf<Int>()
-    private var lastMoveRow = -1
-    private var lastMoveCol = -1
+    // Game state (copied from the shared native buffer only when it changes)
+    private var stateBuffer: GameStateBuffer? = null
+    private val state = GameStateBuffer.State()
 
     override fun onSurfaceCreated(gl: GL10?, config: EGLConfig?) {
         // Set clear color
@@ -76,6 +73,9 @@ class GameRenderer : GLSurfaceView.Renderer {
     }
     
     override fun onDrawFrame(gl: GL10?) {
+        // Refresh the local copy; a no-op when the native state has not changed
+        stateBuffer?.readInto(state)
+        
         gl?.glClear(GL10.GL_COLOR_BUFFER_BIT)
         
         // Draw the board
@@ -202,7 +202,10 @@ class GameRenderer : GLSurfaceView.Renderer {
         val halfBoard = (BOARD_SIZE * CELL_SIZE) / 2
 
         // Draw Black player's valid moves (blue circles)
-        for (moveIndex in validMovesBlack) {
+        var blackMoves = state.blackMoves
+        while (blackMoves != 0L) {
+            val moveIndex = java.lang.Long.numberOfTrailingZeros(blackMoves)
+            blackMoves = blackMoves and (blackMoves - 1)
             val row = moveIndex / BOARD_SIZE
             val col = moveIndex % BOARD_SIZE
 
@@ -218,7 +221,10 @@ class GameRenderer : GLSurfaceView.Renderer {
         }
 
         // Draw White player's valid moves (orange circles)
-        for (moveIndex in validMovesWhite) {
+        var whiteMoves = state.whiteMoves
+        while (whiteMoves != 0L) {
+            val moveIndex = java.lang.Long.numberOfTrailingZeros(whiteMoves)
+            whiteMoves = whiteMoves and (whiteMoves - 1)
             val row = moveIndex / BOARD_SIZE
             val col = moveIndex % BOARD_SIZE
 
@@ -235,11 +241,11 @@ class GameRenderer : GLSurfaceView.Renderer {
     }
     
     private fun drawLastMoveMarker(gl: GL10?) {
-        if (lastMoveRow < 0 || lastMoveCol < 0) return
+        if (state.lastMoveRow < 0 || state.lastMoveCol < 0) return
         
         val halfBoard = (BOARD_SIZE * CELL_SIZE) / 2
-        val row = lastMoveRow
-        val col = lastMoveCol
+        val row = state.lastMoveRow
+        val col = state.lastMoveCol
         
         val left = col * CELL_SIZE - halfBoard
         val right = (col + 1) * CELL_SIZE - halfBoard
@@ -254,10 +260,10 @@ class GameRenderer : GLSurfaceView.Renderer {
         val halfBoard = (BOARD_SIZE * CELL_SIZE) / 2
         val centerOffset = CELL_SIZE / 2
         
-        for (i in 0 until 64) {
+        for (i in 0 until BOARD_SIZE * BOARD_SIZE) {
             val row = i / BOARD_SIZE
             val col = i % BOARD_SIZE
-            val piece = boardState[i]
+            val piece = state.board[i]
             
             if (piece == Player.BLACK || piece == Player.WHITE) {
                 val cx = col * CELL_SIZE + centerOffset - halfBoard
@@ -310,18 +316,10 @@ class GameRenderer : GLSurfaceView.Renderer {
         gl?.glDrawArrays(GL10.GL_TRIANGLE_FAN, 0, segments + 2)
     }
     
-    // Public methods to update game state
-    fun updateBoardState(newState: IntArray) {
-        boardState = newState.copyOf()
-    }
-
-    fun updateValidMoves(blackMoves: Set<Int>, whiteMoves: Set<Int>) {
-        validMovesBlack = blackMoves.toMutableSet()
-        validMovesWhite = whiteMoves.toMutableSet()
-    }
-
-    fun setLastMove(row: Int, col: Int) {
-        lastMoveRow = row
-        lastMoveCol = col
+    /**
+     * Read game state from the buffer the native engine publishes into
+     */
+    fun setStateBuffer(buffer: GameStateBuffer) {
+        stateBuffer = buffer
     }
 }
@@ -0,0 +1,100 @@
+package com.example.reversi
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Game state shared with the native engine through a direct buffer.
+ * The native side republishes it after every state change; the layout
+ * mirrors SharedGameState in SharedState.h.
+ */
+class GameStateBuffer {
+
+    /**
+     * Consistent copy of one published state
+     */
+    class State {
+        val board = IntArray(64)
+        var currentPlayer = Player.BLACK
+        var lastMoveRow = -1
+        var lastMoveCol = -1
+        var winner = -1
+        var blackScore = 0
+        var whiteScore = 0
+        var blackMoves = 0L
+        var whiteMoves = 0L
+        
+        // Sequence number of the copied state (-1 = nothing copied yet)
+        var version = -1
+        
+        fun movesFor(player: Int): Long = if (player == Player.BLACK) blackMoves else whiteMoves
+    }
+    
+    /**
+     * Buffer to register with ReversiLib.registerStateBuffer
+     */
+    val buffer: ByteBuffer = ByteBuffer.allocateDirect(SIZE).order(ByteOrder.nativeOrder())
+    
+    @Volatile private var fence = 0
+    
+    /**
+     * Copy the published state into [out] unless it already holds the latest version
+     * @return true if [out] was updated
+     */
+    fun readInto(out: State): Boolean {
+        while (true) {
+            val before = buffer.getInt(OFFSET_SEQUENCE)
+            if (before == out.version) return false
+            
+            // Odd sequence: native code is in the middle of an update
+            if ((before and 1) != 0) {
+                Thread.yield()
+                continue
+            }
+            
+            loadFence()
+            for (i in 0 until 64) {
+                out.board[i] = buffer.get(OFFSET_BOARD + i).toInt()
+            }
+            out.currentPlayer = buffer.get(OFFSET_CURRENT_PLAYER).toInt()
+            out.lastMoveRow = buffer.get(OFFSET_LAST_MOVE_ROW).toInt()
+            out.lastMoveCol = buffer.get(OFFSET_LAST_MOVE_COL).toInt()
+            out.winner = buffer.get(OFFSET_WINNER).toInt()
+            out.blackScore = buffer.get(OFFSET_BLACK_SCORE).toInt() and 0xFF
+            out.whiteScore = buffer.get(OFFSET_WHITE_SCORE).toInt() and 0xFF
+            out.blackMoves = buffer.getLong(OFFSET_BLACK_MOVES)
+            out.whiteMoves = buffer.getLong(OFFSET_WHITE_MOVES)
+            loadFence()
+            
+            // Retry if an update started while we were copying
+            if (buffer.getInt(OFFSET_SEQUENCE) == before) {
+                out.version = before
+                return true
+            }
+        }
+    }
+    
+    /**
+     * Order plain buffer reads around the sequence checks. There is no portable
+     * load fence below API 33; a volatile store followed by a volatile load acts as one.
+     */
+    private fun loadFence() {
+        fence = 0
+        if (fence != 0) Thread.yield()
+    }
+    
+    companion object {
+        const val SIZE = 96
+        
+        private const val OFFSET_SEQUENCE = 0
+        private const val OFFSET_CURRENT_PLAYER = 4
+        private const val OFFSET_LAST_MOVE_ROW = 5
+        private const val OFFSET_LAST_MOVE_COL = 6
+        private const val OFFSET_WINNER = 7
+        private const val OFFSET_BLACK_SCORE = 8
+        private const val OFFSET_WHITE_SCORE = 9
+        private const val OFFSET_BLACK_MOVES = 16
+        private const val OFFSET_WHITE_MOVES = 24
+        private const val OFFSET_BOARD = 32
+    }
+}
@@ -7,9 +7,12 @@ import android.opengl.GLSurfaceView
 import android.os.Bundle
 import android.os.Handler
 import android.os.Looper
+import android.os.ParcelFileDescriptor
 import android.view.View
 import android.widget.Button
 import android.widget.TextView
+import java.io.File
+import java.io.IOException
 import java.util.Locale
 import java.util.concurrent.ExecutorService
 import java.util.concurrent.Executors
@@ -35,10 +38,16 @@ class MainActivity : Activity() {
     private lateinit var reversiLib: ReversiLib
     private lateinit var renderer: GameRenderer
     
+    // Game state published by the native engine (shared with the renderer)
+    private val stateBuffer = GameStateBuffer()
+    private val uiState = GameStateBuffer.State()
+    
     // Game state
     private var gameMode = GameMode.PLAYER_VS_PLAYER
     private var aiDifficulty = AIDifficulty.MEDIUM
     private var isProcessingMove = false
+    @Volatile private var isAIThinking = false
+    private var isRestoringSession = false
     private var currentLanguage = "en"
     
     // Thread for AI calculation
@@ -85,6 +94,7 @@ class MainActivity : Activity() {
         
         // Setup OpenGL renderer
         renderer = GameRenderer()
+        renderer.setStateBuffer(stateBuffer)
         glSurfaceView.setRenderer(renderer)
         glSurfaceView.renderMode = GLSurfaceView.RENDERMODE_WHEN_DIRTY
     }
@@ -92,7 +102,111 @@ class MainActivity : Activity() {
     private fun initializeGame() {
         reversiLib = ReversiLib(this)
         reversiLib.initGame()
+        reversiLib.registerStateBuffer(stateBuffer.buffer)
+        loadEvaluator()
+        // Queued ahead of any AI turn, off the UI thread
+        val solvedStoreFile = File(filesDir, SOLVED_STORE_FILE)
+        aiExecutor.execute {
+            reversiLib.openSolvedStore(solvedStoreFile.absolutePath)
+        }
+        
+        // The snapshot replaces the AI's caches, so it is restored on the AI thread too, after
+        // the network and store are in place; input (and saving) waits for it
+        isRestoringSession = true
+        isProcessingMove = true
+        btnNewGame.isEnabled = false
         updateUI()
+        aiExecutor.execute {
+            val restored = restoreSession()
+            mainHandler.post {
+                if (restored) {
+                    restoreSessionSettings()
+                }
+                isRestoringSession = false
+                isProcessingMove = false
+                btnNewGame.isEnabled = true
+                updateUI()
+                glSurfaceView.requestRender()
+                
+                // Resume an interrupted AI turn
+                if (restored) {
+                    checkAITurn()
+                }
+            }
+        }
+    }
+    
+    /**
+     * Use an evaluation network if one has been installed in the app's files
+     * (loaded on the AI thread, so it never swaps the network under a search)
+     */
+    private fun loadEvaluator() {
+        val file = File(filesDir, EVALUATOR_FILE)
+        aiExecutor.execute {
+            if (file.exists()) {
+                reversiLib.loadEvaluator(file.absolutePath)
+            }
+        }
+    }
+    
+    /**
+     * Restore the session saved when the app was last paused (on the AI thread)
+     * @return true if a saved game was restored
+     */
+    private fun restoreSession(): Boolean {
+        val file = File(filesDir, SESSION_FILE)
+        if (!file.exists()) return false
+        
+        return try {
+            ParcelFileDescriptor.open(file, ParcelFileDescriptor.MODE_READ_ONLY).use { pfd ->
+                reversiLib.loadSnapshotFromFd(pfd.fd)
+            }
+        } catch (e: IOException) {
+            false
+        }
+    }
+    
+    /**
+     * Game mode and difficulty of the restored session
+     */
+    private fun restoreSessionSettings() {
+        val prefs = getSharedPreferences("reversi_prefs", MODE_PRIVATE)
+        gameMode = prefs.getInt("game_mode", GameMode.PLAYER_VS_PLAYER)
+        aiDifficulty = prefs.getInt("ai_difficulty", AIDifficulty.MEDIUM)
+    }
+    
+    /**
+     * Save the session so it survives the process being killed in the background
+     */
+    private fun saveSession() {
+        // Paused before the saved session was restored: keep it
+        if (isRestoringSession) return
+        
+        val file = File(filesDir, SESSION_FILE)
+        val tempFile = File(filesDir, "$SESSION_FILE.tmp")
+        
+        val saved = try {
+            ParcelFileDescriptor.open(tempFile, ParcelFileDescriptor.MODE_WRITE_ONLY or
+                    ParcelFileDescriptor.MODE_CREATE or ParcelFileDescriptor.MODE_TRUNCATE).use { pfd ->
+                // The AI's caches change while it is thinking, so only save them when idle
+                reversiLib.saveSnapshotToFd(pfd.fd, !isAIThinking)
+            }
+        } catch (e: IOException) {
+            false
+        }
+        
+        // Replace the previous snapshot only once the new one is complete
+        if (saved) {
+            tempFile.renameTo(file)
+        } else {
+            tempFile.delete()
+        }
+        
+        val prefs = getSharedPreferences("reversi_prefs", MODE_PRIVATE)
+        prefs.edit()
+            .putInt("game_mode", gameMode)
+            .putInt("ai_difficulty", aiDifficulty)
+            .apply()
     }
     
     private fun setupListeners() {
@@ -195,11 +309,13 @@ class MainActivity : Activity() {
                 btnNewGame.isEnabled = false
             }
             
+            isAIThinking = true
             aiExecutor.execute {
                 // Small delay for better UX
                 Thread.sleep(500)
                 
                 val aiMove = reversiLib.getAIMove()
+                isAIThinking = false
                 val row = aiMove[0]
                 val col = aiMove[1]
                 
@@ -234,13 +350,16 @@ class MainActivity : Activity() {
     }
     
     private fun updateUI() {
+        // Scores, turn and valid moves come from the shared state buffer
+        // (the renderer reads board, highlights and last move from it too)
+        stateBuffer.readInto(uiState)
+        
         // Update scores
-        val scores = reversiLib.getScores()
-        tvBlackScore.text = getString(R.string.black_score_format, scores[0])
-        tvWhiteScore.text = getString(R.string.white_score_format, scores[1])
+        tvBlackScore.text = getString(R.string.black_score_format, uiState.blackScore)
+        tvWhiteScore.text = getString(R.string.white_score_format, uiState.whiteScore)
 
         // Update turn indicator
-        val currentPlayer = reversiLib.getCurrentPlayer()
+        val currentPlayer = uiState.currentPlayer
         tvTurnIndicator.text = when (currentPlayer) {
             Player.BLACK -> getString(R.string.turn_black)
             Player.WHITE -> getString(R.string.turn_white)
@@ -250,39 +369,7 @@ class MainActivity : Activity() {
         // Update button states
         btnUndo.isEnabled = reversiLib.canUndo() && !isProcessingMove
         btnRedo.isEnabled = reversiLib.canRedo() && !isProcessingMove
-        btnPass.isEnabled = reversiLib.playerCanMove(currentPlayer) && !isProcessingMove
-
-        // Update board display
-        val boardState = reversiLib.getBoardState()
-        renderer.updateBoardState(boardState)
-
-        // Update valid move highlights for BOTH players
-        val validMovesBlack = mutableSetOf<Int>()
-        val validMovesWhite = mutableSetOf<Int>()
-
-        // Get Black's valid moves
-        if (reversiLib.playerCanMove(Player.BLACK)) {
-            for (row in 0..7) {
-                for (col in 0..7) {
-                    if (reversiLib.canMove(row, col, Player.BLACK)) {
-                        validMovesBlack.add(row * 8 + col)
-                    }
-                }
-            }
-        }
-
-        // Get White's valid moves
-        if (reversiLib.playerCanMove(Player.WHITE)) {
-            for (row in 0..7) {
-                for (col in 0..7) {
-                    if (reversiLib.canMove(row, col, Player.WHITE)) {
-                        validMovesWhite.add(row * 8 + col)
-                    }
-                }
-            }
-        }
-
-        renderer.updateValidMoves(validMovesBlack, validMovesWhite)
+        btnPass.isEnabled = uiState.movesFor(currentPlayer) != 0L && !isProcessingMove
     }
     
     private fun showGameSetupDialog() {
@@ -320,10 +407,9 @@ class MainActivity : Activity() {
     }
     
     private fun showGameOverDialog() {
-        val scores = reversiLib.getScores()
-        val winner = reversiLib.getWinner()
+        stateBuffer.readInto(uiState)
         
-        val dialog = GameOverDialog(this, winner, scores[0], scores[1]) {
+        val dialog = GameOverDialog(this, uiState.winner, uiState.blackScore, uiState.whiteScore) {
             showGameSetupDialog()
         }
         dialog.show()
@@ -337,10 +423,21 @@ class MainActivity : Activity() {
     override fun onPause() {
         super.onPause()
         glSurfaceView.onPause()
+        saveSession()
+        
+        // Only trace-enabled native builds write anything
+        reversiLib.writeTrace(File(filesDir, TRACE_FILE).absolutePath)
     }
     
     override fun onDestroy() {
         super.onDestroy()
         aiExecutor.shutdown()
     }
+    
+    companion object {
+        private const val SESSION_FILE = "session.snapshot"
+        private const val EVALUATOR_FILE = "evaluator.rvnn"
+        private const val TRACE_FILE = "trace.json"
+        private const val SOLVED_STORE_FILE = "solved.rvss"
+    }
 }
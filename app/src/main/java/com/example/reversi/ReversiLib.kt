@@ -1,6 +1,7 @@
 package com.example.reversi
 
 import android.content.Context
+import java.nio.ByteBuffer
 
 /**
  * JNI wrapper class for the native C++ game engine
@@ -32,7 +33,7 @@ class ReversiLib(context: Context) {
     /**
      * Reset the game
      * @param gameMode 0 = PvP, 1 = PvAI
-     * @param difficulty 0 = Easy, 1 = Medium, 2 = Hard, 3 = Expert
+     * @param difficulty 0 = Easy, 1 = Medium, 2 = Hard, 3 = Expert, 4 = Monte Carlo
      */
     external fun resetGame(gameMode: Int, difficulty: Int)
     
@@ -60,9 +61,14 @@ class ReversiLib(context: Context) {
      */
     external fun passTurn()
     
+    /**
+     * Get board size (squares per side)
+     */
+    external fun getBoardSize(): Int
+    
     /**
      * Get board state
-     * @return IntArray of size 64 (0=empty, 1=black, 2=white)
+     * @return IntArray of getBoardSize() * getBoardSize() squares, row-major (0=empty, 1=black, 2=white)
      */
     external fun getBoardState(): IntArray
     
@@ -124,6 +130,57 @@ class ReversiLib(context: Context) {
      * Get valid moves count for a player
      */
     external fun getValidMovesCount(player: Int): Int
+    
+    /**
+     * Save the whole session (board, side to move, undo/redo history, AI settings)
+     * @param includeCaches also save the AI's search caches so it resumes warm
+     * @return versioned binary snapshot
+     */
+    external fun saveSnapshot(includeCaches: Boolean): ByteArray
+    
+    /**
+     * Restore a session saved by saveSnapshot
+     * @return false if the snapshot is invalid (current game is kept)
+     */
+    external fun loadSnapshot(data: ByteArray): Boolean
+    
+    /**
+     * Save the session to an open file descriptor (caller closes it)
+     */
+    external fun saveSnapshotToFd(fd: Int, includeCaches: Boolean): Boolean
+    
+    /**
+     * Restore the session from an open file descriptor (caller closes it)
+     */
+    external fun loadSnapshotFromFd(fd: Int): Boolean
+    
+    /**
+     * Register a direct buffer (see GameStateBuffer) that the engine republishes
+     * board, scores, valid-move masks and last move into after every change
+     * @return false if the buffer is not direct, too small or misaligned
+     */
+    external fun registerStateBuffer(buffer: ByteBuffer): Boolean
+    
+    /**
+     * Use an evaluation network file (written by tools/nn_train) for the AI's searches.
+     * Call it on the AI thread: the previous network is unmapped.
+     * @return false if the file is missing or invalid (the built-in evaluation stays in use)
+     */
+    external fun loadEvaluator(path: String): Boolean
+    
+    /**
+     * Keep exactly solved endgame positions in a file that persists across sessions;
+     * the AI plays stored positions instantly and adds the ones it solves.
+     * Call it on the AI thread: it reads (and may compact) the whole file.
+     * @return false if the file cannot be opened or written (the AI solves without it)
+     */
+    external fun openSolvedStore(path: String): Boolean
+    
+    /**
+     * Write the native trace events recorded so far as Chrome trace JSON
+     * @return false if the library was built without REVERSI_TRACE or the file cannot be written
+     */
+    external fun writeTrace(path: String): Boolean
 }
 
 // Game mode constants
@@ -138,6 +195,7 @@ object AIDifficulty {
     const val MEDIUM = 1
     const val HARD = 2
     const val EXPERT = 3
+    const val MCTS = 4
 }
 
 // Player constants